@@ -0,0 +1,549 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Camera.hpp"
+#include "cpu/CPURenderer.hpp"
+#include "cpu/DistanceCulling.hpp"
+#include "cpu/FixedPointKernel.hpp"
+#include "cpu/Pan.hpp"
+#include "cpu/PrecisionLadder.hpp"
+#include "cpu/Reprojection.hpp"
+#include "cpu/ScalarKernel.hpp"
+#include "cpu/SIMDKernel.hpp"
+
+
+/* Headless benchmark of the CPU render engine.
+ * Renders a view several times and reports the throughput in Mpixel/s.
+ */
+
+struct View
+{
+    char const* name;
+    FractalType type;
+    glm::dvec2 origin;
+    double zoomLevel;
+};
+
+const View views[] = {
+    {"home",      FractalType::Mandelbrot, glm::dvec2(0.0, 0.0),              0.5},
+    {"seahorse",  FractalType::Mandelbrot, glm::dvec2(-0.7453, 0.1127),       150.0},
+    {"elephant",  FractalType::Mandelbrot, glm::dvec2(0.2816, 0.0085),        60.0},
+    {"julia",     FractalType::Julia,      glm::dvec2(0.0, 0.0),              0.6},
+    {"minibrot",  FractalType::Mandelbrot, glm::dvec2(-1.7605, 0.0),          60.0},
+    {"spiral",    FractalType::Mandelbrot, glm::dvec2(-0.743643887037151, 0.131825904205330), 1e6},
+    {"dendrite",  FractalType::Mandelbrot, glm::dvec2(0.0, 1.0),              1e20}, //c = i, whose Julia set is a dendrite
+};
+
+struct Options
+{
+    Options():
+        view(&views[0]),
+        width(1024),
+        height(1024),
+        maxIter(1000),
+        repeat(3),
+        threads(0),
+        tileSize(64),
+        kernel("simd"),
+        mode(RenderMode::BruteForce),
+        precision("float"),
+        check(false),
+        cardioidCheck(true),
+        periodicityCheck(true),
+        periodicityTolerance(defaultPeriodicityTolerance),
+        intervalCheck(true),
+        symmetryCheck(true),
+        progressive(false),
+        pan(false),
+        panX(0),
+        panY(0),
+        zoom(0.0),
+        seed(-0.8, 0.156),
+        customCenter(false),
+        center(0.0, 0.0),
+        zoomLevel(0.0)
+    {}
+
+    View const* view;
+    unsigned int width, height;
+    unsigned int maxIter;
+    unsigned int repeat;
+    unsigned int threads;
+    unsigned int tileSize;
+    std::string kernel;
+    RenderMode mode;
+    std::string precision;
+    bool check;
+    bool cardioidCheck;
+    bool periodicityCheck;
+    double periodicityTolerance;
+    bool intervalCheck;
+    bool symmetryCheck;
+    bool progressive;
+    bool pan;
+    int panX, panY;
+    double zoom;
+    std::vector<unsigned int> maxIterSteps;
+    glm::dvec2 seed;
+    bool customCenter;
+    glm::dvec2 center;
+    double zoomLevel; //0 for that of the view
+    std::string output;
+};
+
+void printUsage()
+{
+    std::cout << "usage: fractal-bench [options]" << std::endl
+              << "  --view NAME         home, seahorse, elephant, julia, minibrot, spiral, dendrite (default home)" << std::endl
+              << "  --center X,Y        moves the view to this center" << std::endl
+              << "  --zoomlevel Z       zooms the view to this level, the half-height of the view being 1/Z" << std::endl
+              << "  --size WxH          resolution (default 1024x1024)" << std::endl
+              << "  --maxiter N         maximum iteration count (default 1000)" << std::endl
+              << "  --seed X,Y          Julia seed (default -0.8,0.156)" << std::endl
+              << "  --kernel K          scalar, sse2, avx2, avx512 or simd for the best one (default simd)" << std::endl
+              << "                      options can be appended: -refill to reload vector lanes as soon as they are done," << std::endl
+              << "                      -defer4, -defer8 or -defer16 to test for escape once per block of iterations" << std::endl
+              << "  --precision P       float, double or double-double for the kernel of --kernel," << std::endl
+              << "                      fixed128 for the scalar fixed-point kernel, whatever --kernel," << std::endl
+              << "                      or auto for the cheapest that resolves the view (default float)" << std::endl
+              << "  --mode M            brute-force, mariani-silver, boundary-trace, solid-guessing" << std::endl
+              << "                      or distance-culling (default brute-force)" << std::endl
+              << "  --check             compares the result with a brute-force scalar render," << std::endl
+              << "                      and fixed128 results with a double-double one too;" << std::endl
+              << "                      pixels filled by distance culling may be off by " << maxCulledError << std::endl
+              << "  --no-cardioid       iterates the main cardioid and period-2 bulb too" << std::endl
+              << "  --no-periodicity    disables cycle detection" << std::endl
+              << "  --no-interval       disables the interval arithmetic classification of tiles" << std::endl
+              << "  --no-symmetry       renders the pixels that mirror others too" << std::endl
+              << "  --progressive       then renders in passes of 1/8, 1/4, 1/2 and full resolution" << std::endl
+              << "  --pan DX,DY         then moves the camera by DX,DY pixels, and only renders the exposed strips" << std::endl
+              << "  --resume N,M,...    then changes maxIter to N, M... in turn, only iterating the pixels that hadn't escaped" << std::endl
+              << "  --zoom F            then zooms like the mouse wheel (Camera::zoom), resamples the frame as a preview" << std::endl
+              << "                      and renders it again tile by tile, worst first" << std::endl
+              << "  --tolerance T       cycle detection tolerance, in pixels (default " << defaultPeriodicityTolerance << ")" << std::endl
+              << "  --threads N         worker threads, 0 for all hardware threads (default 0)" << std::endl
+              << "  --tile N            tile size in pixels (default 64)" << std::endl
+              << "  --repeat N          number of timed renders (default 3)" << std::endl
+              << "  --output FILE.ppm   saves the last render" << std::endl;
+}
+
+RenderMode parseRenderMode (std::string const& name)
+{
+    const RenderMode modes[] = {RenderMode::BruteForce, RenderMode::MarianiSilver, RenderMode::BoundaryTrace,
+                                 RenderMode::SolidGuessing, RenderMode::DistanceCulling};
+    for (RenderMode mode : modes) {
+        if (name == getRenderModeName(mode))
+            return mode;
+    }
+
+    throw std::runtime_error("unknown render mode " + name);
+}
+
+Options parseOptions (int argc, char** argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(EXIT_SUCCESS);
+        }
+        if (arg == "--check") {
+            options.check = true;
+            continue;
+        }
+        if (arg == "--no-cardioid") {
+            options.cardioidCheck = false;
+            continue;
+        }
+        if (arg == "--no-periodicity") {
+            options.periodicityCheck = false;
+            continue;
+        }
+        if (arg == "--no-interval") {
+            options.intervalCheck = false;
+            continue;
+        }
+        if (arg == "--no-symmetry") {
+            options.symmetryCheck = false;
+            continue;
+        }
+        if (arg == "--progressive") {
+            options.progressive = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            throw std::runtime_error("missing value for " + arg);
+
+        std::string value = argv[++i];
+        if (arg == "--view") {
+            options.view = nullptr;
+            for (View const& view : views) {
+                if (value == view.name)
+                    options.view = &view;
+            }
+            if (!options.view)
+                throw std::runtime_error("unknown view " + value);
+        } else if (arg == "--size") {
+            if (std::sscanf(value.c_str(), "%ux%u", &options.width, &options.height) != 2)
+                throw std::runtime_error("invalid size " + value);
+        } else if (arg == "--maxiter") {
+            options.maxIter = std::stoul(value);
+        } else if (arg == "--seed") {
+            if (std::sscanf(value.c_str(), "%lf,%lf", &options.seed.x, &options.seed.y) != 2)
+                throw std::runtime_error("invalid seed " + value);
+        } else if (arg == "--center") {
+            if (std::sscanf(value.c_str(), "%lf,%lf", &options.center.x, &options.center.y) != 2)
+                throw std::runtime_error("invalid center " + value);
+            options.customCenter = true;
+        } else if (arg == "--zoomlevel") {
+            options.zoomLevel = std::stod(value);
+            if (!(options.zoomLevel > 0.0))
+                throw std::runtime_error("invalid zoom level " + value);
+        } else if (arg == "--pan") {
+            if (std::sscanf(value.c_str(), "%d,%d", &options.panX, &options.panY) != 2)
+                throw std::runtime_error("invalid pan " + value);
+            options.pan = true;
+        } else if (arg == "--resume") {
+            std::stringstream stream(value);
+            for (std::string token; std::getline(stream, token, ','); ) {
+                options.maxIterSteps.push_back(std::stoul(token));
+            }
+        } else if (arg == "--zoom") {
+            options.zoom = std::stod(value);
+        } else if (arg == "--kernel") {
+            options.kernel = value;
+        } else if (arg == "--precision") {
+            options.precision = value;
+        } else if (arg == "--mode") {
+            options.mode = parseRenderMode(value);
+        } else if (arg == "--threads") {
+            options.threads = std::stoul(value);
+        } else if (arg == "--tile") {
+            options.tileSize = std::stoul(value);
+        } else if (arg == "--tolerance") {
+            options.periodicityTolerance = std::stod(value);
+        } else if (arg == "--repeat") {
+            options.repeat = std::stoul(value);
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            throw std::runtime_error("unknown option " + arg);
+        }
+    }
+
+    return options;
+}
+
+void savePPM (std::string const& filepath, std::vector<std::uint8_t> const& rgba, unsigned int width, unsigned int height)
+{
+    std::ofstream file(filepath.c_str(), std::ios::binary);
+    if (!file)
+        throw std::runtime_error("unable to write " + filepath);
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+    for (unsigned int y = height; y-- > 0; ) { //row 0 is the bottom row
+        for (unsigned int x = 0; x < width; ++x) {
+            file.write(reinterpret_cast<char const*>(&rgba[4 * (y * width + x)]), 3);
+        }
+    }
+}
+
+/* name is a kernel followed by options separated by dashes, e.g. avx2-refill-defer8 */
+template<typename T>
+std::unique_ptr<EscapeTimeKernel> createKernel (std::string const& name)
+{
+    std::vector<std::string> tokens;
+    std::stringstream stream(name);
+    for (std::string token; std::getline(stream, token, '-'); ) {
+        tokens.push_back(token);
+    }
+    if (tokens.empty())
+        throw std::runtime_error("empty kernel name");
+
+    LaneMode laneMode = LaneMode::Batch;
+    unsigned int bailoutInterval = 1;
+    for (std::size_t i = 1; i < tokens.size(); ++i) {
+        if (tokens[i] == "refill" && tokens[0] != "scalar")
+            laneMode = LaneMode::Refill;
+        else if (tokens[i].compare(0, 5, "defer") == 0 && tokens[i].size() > 5)
+            bailoutInterval = std::stoul(tokens[i].substr(5));
+        else
+            throw std::runtime_error("unknown kernel option " + tokens[i]);
+    }
+
+    EscapeTimeKernel* kernel = nullptr;
+    if (tokens[0] == "scalar")
+        kernel = new ScalarKernel<T>(bailoutInterval);
+    else if (tokens[0] == "simd")
+        kernel = new SIMDKernel<T>(laneMode, bailoutInterval);
+    else if (tokens[0] == "sse2")
+        kernel = new SIMDKernel<T>(SIMDLevel::SSE2, laneMode, bailoutInterval);
+    else if (tokens[0] == "avx2")
+        kernel = new SIMDKernel<T>(SIMDLevel::AVX2, laneMode, bailoutInterval);
+    else if (tokens[0] == "avx512")
+        kernel = new SIMDKernel<T>(SIMDLevel::AVX512, laneMode, bailoutInterval);
+    else
+        throw std::runtime_error("unknown kernel " + tokens[0]);
+
+    return std::unique_ptr<EscapeTimeKernel>(kernel);
+}
+
+std::unique_ptr<EscapeTimeKernel> createKernel (std::string const& name, std::string const& precision)
+{
+    if (precision == "float")
+        return createKernel<float>(name);
+    if (precision == "double")
+        return createKernel<double>(name);
+    if (precision == "double-double")
+        return createKernel<DoubleDouble>(name);
+    if (precision == "fixed128")
+        return std::unique_ptr<EscapeTimeKernel>(new FixedPointKernel());
+
+    throw std::runtime_error("unknown precision " + precision);
+}
+
+/* Name of the precision the navigator picks for the view */
+std::string selectPrecision (RenderParameters const& parameters, unsigned int width, unsigned int height)
+{
+    PrecisionLadder ladder;
+    ladder.add(Precision::Float);
+    ladder.add(Precision::Double);
+    ladder.add(Precision::DoubleDouble);
+    ladder.add(Precision::Fixed128);
+    ladder.select(parameters, width, height);
+    if (!ladder.resolvesView())
+        std::cout << "warning: no kernel resolves the view, pixels merge into blocks" << std::endl;
+
+    return getPrecisionName(ladder.getPrecision());
+}
+
+/* Number of pixels that differ from a single-threaded brute-force scalar render */
+/* Number of pixels of buffer whose counts differ from a brute-force scalar render.
+ * With culled (see CPURenderer::setCulledPixels), the pixels distance culling filled only count
+ * if they are off by more than maxCulledError, and offCulled receives how many are off at all.
+ */
+std::size_t countMismatches (RenderParameters parameters, std::string const& precision, IterationBuffer const& buffer,
+                             IterationBuffer const* culled=nullptr, std::size_t* offCulled=nullptr)
+{
+    parameters.cardioidCheck = false;
+    parameters.periodicityCheck = false;
+    parameters.intervalCheck = false;
+    parameters.symmetryCheck = false;
+    parameters.step = 1;
+    parameters.knownStep = 0;
+
+    std::unique_ptr<EscapeTimeKernel> reference = createKernel("scalar", precision);
+    CPURenderer renderer(*reference, 1);
+    IterationBuffer expected(buffer.getWidth(), buffer.getHeight());
+    renderer.render(parameters, expected);
+
+    std::size_t mismatches = 0, off = 0;
+    for (std::size_t i = 0; i < expected.getData().size(); ++i) {
+        const unsigned int count = buffer.getData()[i], expectedCount = expected.getData()[i];
+        if (count == expectedCount)
+            continue;
+
+        if (culled && culled->getData()[i] != 0) {
+            ++off;
+            if (std::max(count, expectedCount) - std::min(count, expectedCount) <= maxCulledError)
+                continue;
+        }
+        ++mismatches;
+    }
+
+    if (offCulled)
+        *offCulled = off;
+    return mismatches;
+}
+
+int main (int argc, char** argv)
+{
+    try {
+        Options options = parseOptions(argc, argv);
+
+        Camera camera(options.width, options.height,
+                      options.customCenter ? options.center : options.view->origin,
+                      (options.zoomLevel > 0.0) ? options.zoomLevel : options.view->zoomLevel);
+
+        RenderParameters parameters;
+        parameters.type = options.view->type;
+        parameters.seed = options.seed;
+        parameters.maxIter = options.maxIter;
+        parameters.invViewMatrix = camera.getInvViewMatrix();
+        parameters.anchor = camera.getAnchor();
+        parameters.panPixels = camera.getPanPixels();
+        parameters.cardioidCheck = options.cardioidCheck;
+        parameters.periodicityCheck = options.periodicityCheck;
+        parameters.periodicityTolerance = options.periodicityTolerance;
+        parameters.intervalCheck = options.intervalCheck;
+        parameters.symmetryCheck = options.symmetryCheck;
+
+        if (options.precision == "auto")
+            options.precision = selectPrecision(parameters, options.width, options.height);
+
+        std::unique_ptr<EscapeTimeKernel> kernel = createKernel(options.kernel, options.precision);
+        CPURenderer renderer(*kernel, options.threads);
+        renderer.setTileSize(options.tileSize);
+        renderer.setRenderMode(options.mode);
+        IterationBuffer buffer(options.width, options.height);
+        IterationBuffer culled(options.width, options.height);
+        renderer.setCulledPixels(&culled);
+
+        std::cout << "view " << options.view->name << ", " << options.width << "x" << options.height
+                  << ", maxIter " << options.maxIter << ", kernel " << kernel->getName()
+                  << ", mode " << getRenderModeName(renderer.getRenderMode())
+                  << ", " << renderer.getThreadCount() << " threads, tile " << renderer.getTileSize() << std::endl;
+
+        double bestSeconds = 0.0;
+        for (unsigned int i = 0; i < options.repeat; ++i) {
+            renderer.render(parameters, buffer);
+            RenderStats const& stats = renderer.getStats();
+            std::cout << "  " << stats.seconds * 1000.0 << " ms, "
+                      << stats.getMegaPixelsPerSecond() << " Mpixel/s, "
+                      << stats.iterations / stats.seconds * 1e-6 << " Miter/s" << std::endl;
+
+            if (i == 0 || stats.seconds < bestSeconds)
+                bestSeconds = stats.seconds;
+        }
+        if (options.repeat > 0) {
+            RenderStats const& stats = renderer.getStats();
+            std::cout << "best: " << static_cast<double>(options.width) * options.height / bestSeconds * 1e-6
+                      << " Mpixel/s" << std::endl;
+            std::cout << "computed: " << stats.computedPixels << " pixels ("
+                      << 100.0 * stats.getComputedFraction() << "%), "
+                      << stats.pixels - stats.computedPixels << " filled" << std::endl;
+            std::cout << "classified: " << stats.classifiedPixels << " pixels proven uniform by interval arithmetic ("
+                      << 100.0 * stats.classifiedPixels / stats.pixels << "%)" << std::endl;
+            std::cout << "culled: " << stats.culledPixels << " pixels filled from a distance estimate ("
+                      << 100.0 * stats.culledPixels / stats.pixels << "%)" << std::endl;
+            std::cout << "mirrored: " << stats.mirroredPixels << " pixels copied from their mirror image ("
+                      << 100.0 * stats.mirroredPixels / stats.pixels << "%)" << std::endl;
+            std::cout << "skipped: " << stats.cardioidSkipped << " pixels in the main cardioid or period-2 bulb ("
+                      << 100.0 * stats.cardioidSkipped / stats.pixels << "%)" << std::endl;
+            std::cout << "periodic: " << stats.periodicExits << " pixels ("
+                      << 100.0 * stats.periodicExits / stats.pixels << "%)" << std::endl;
+        }
+
+        if (options.progressive) {
+            double totalSeconds = 0.0;
+            parameters.knownStep = 0;
+            for (unsigned int step = 8; step >= 1; step /= 2) {
+                parameters.step = step;
+                renderer.render(parameters, buffer);
+                parameters.knownStep = step;
+
+                RenderStats const& stats = renderer.getStats();
+                totalSeconds += stats.seconds;
+                std::cout << "pass 1/" << step << ": " << stats.seconds * 1000.0 << " ms, "
+                          << stats.computedPixels << " pixels computed" << std::endl;
+            }
+            std::cout << "progressive: " << totalSeconds * 1000.0 << " ms in total" << std::endl;
+        }
+
+        if (options.pan) {
+            /* Movements are in window coordinates, where the width and the height span 2 */
+            camera.relativeMovement(glm::vec2(options.panX * 2.f / options.width, options.panY * 2.f / options.height));
+            RenderParameters panned = parameters;
+            panned.invViewMatrix = camera.getInvViewMatrix();
+            panned.anchor = camera.getAnchor();
+            panned.panPixels = camera.getPanPixels();
+            panned.step = 1;
+            panned.knownStep = 0;
+
+            Pan pan;
+            if (!findPan(parameters, panned, options.width, options.height, pan))
+                throw std::runtime_error("the pan doesn't keep any pixel");
+
+            applyPan(pan, culled);
+            renderer.render(panned, applyPan(pan, buffer), buffer);
+            parameters = panned;
+
+            RenderStats const& stats = renderer.getStats();
+            std::cout << "pan " << pan.offsetX << "," << pan.offsetY << ": " << stats.seconds * 1000.0 << " ms, "
+                      << stats.pixels << " pixels exposed ("
+                      << 100.0 * stats.pixels / (static_cast<double>(options.width) * options.height)
+                      << "% of the frame)" << std::endl;
+        }
+
+        if (!options.maxIterSteps.empty()) {
+            OrbitCache cache;
+            cache.reset(parameters, buffer);
+            for (unsigned int maxIter : options.maxIterSteps) {
+                parameters.maxIter = maxIter;
+                renderer.resume(parameters, cache, buffer);
+
+                RenderStats const& stats = renderer.getStats();
+                std::cout << "maxIter " << maxIter << ": " << stats.seconds * 1000.0 << " ms, "
+                          << stats.computedPixels << " orbits resumed, "
+                          << stats.iterations / stats.seconds * 1e-6 << " Miter/s" << std::endl;
+            }
+        }
+
+        if (options.zoom != 0.0) {
+            /* Towards a point off the center, as the mouse usually is */
+            camera.zoom(camera.windowToWorld(glm::vec2(0.5f, 0.25f)), options.zoom);
+            RenderParameters zoomed = parameters;
+            zoomed.invViewMatrix = camera.getInvViewMatrix();
+            zoomed.anchor = camera.getAnchor();
+            zoomed.panPixels = camera.getPanPixels();
+            zoomed.step = 1;
+            zoomed.knownStep = 0;
+
+            typedef std::chrono::steady_clock Clock;
+            IterationBuffer previous = buffer;
+            Clock::time_point start = Clock::now();
+            Reprojection reprojection = reproject(parameters, previous, zoomed, buffer, renderer.getTileSize());
+            double previewSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+            parameters = zoomed;
+
+            double refineSeconds = 0.0;
+            for (Tile const& tile : reprojection.tiles) {
+                renderer.render(parameters, std::vector<Tile>(1, tile), buffer);
+                refineSeconds += renderer.getStats().seconds;
+            }
+            std::cout << "zoom " << options.zoom << ": preview in " << previewSeconds * 1000.0 << " ms, covering "
+                      << 100.0 * reprojection.coverage << "% of the frame, then " << reprojection.tiles.size()
+                      << " tiles in " << refineSeconds * 1000.0 << " ms" << std::endl;
+        }
+
+        if (options.check) {
+            /* Distance culling fills pixels from an estimate, which is only checked against its bound */
+            std::size_t offCulled = 0;
+            std::size_t mismatches = countMismatches(parameters, options.precision, buffer, &culled, &offCulled);
+            std::cout << "check: " << mismatches << " pixels differ from the scalar reference" << std::endl;
+            if (renderer.getRenderMode() == RenderMode::DistanceCulling)
+                std::cout << "check: " << offCulled << " culled pixels differ by at most " << maxCulledError << std::endl;
+            if (mismatches > 0)
+                return EXIT_FAILURE;
+
+            /* fixed128 has no other kernel to be compared with: it is cross-checked against double-double */
+            if (options.precision == "fixed128") {
+                std::size_t differences = countMismatches(parameters, "double-double", buffer);
+                std::cout << "cross-check: " << differences << " pixels differ from the double-double reference ("
+                          << 100.0 * differences / buffer.getData().size() << "%)" << std::endl;
+            }
+        }
+
+        if (!options.output.empty()) {
+            std::vector<std::uint8_t> rgba;
+            Palette::grayscale().colorize(buffer, options.maxIter, rgba);
+            savePPM(options.output, rgba, options.width, options.height);
+        }
+    } catch (std::exception const& e) {
+        std::cerr << "fractal-bench: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
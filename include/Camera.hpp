@@ -3,45 +3,62 @@
 
 #include "glm.hpp"
 
-#include <SFML/Graphics/Rect.hpp>
-#include <SFML/System/Vector2.hpp>
-
 /* Class for handling translation and scaling.
  * Allows to map window coordinates ([-1,1]x[-1,1]) to world coordinates.
+ * World coordinates are doubles: floats can't tell pixels apart past a zoom of about 1e5,
+ * and the engines that need less narrow them themselves.
  */
 class Camera
 {
     public:
         Camera (unsigned int screenWidth, unsigned screenHeight,
-                glm::vec2 const& origin=glm::vec2(0.f,0.f),
-                float zoomLevel=1.f);
+                glm::dvec2 const& origin=glm::dvec2(0.0,0.0),
+                double zoomLevel=1.0);
+
+        glm::dvec2 const& getOrigin() const;
+        glm::dvec2 getViewSize() const;
+        double getZoomLevel () const;
 
-        glm::vec2 const& getOrigin() const;
-        glm::vec2 getViewSize() const;
-        float getZoomLevel () const;
+        /* The origin is the anchor moved by a whole number of pixels of the screen, see relativeMovement */
+        glm::dvec2 const& getAnchor() const;
+        glm::ivec2 const& getPanPixels() const;
         
         /* Maps window coordinates ([-1,1]x[-1,1]) to world coordinates */
-        glm::mat3 const& getInvViewMatrix() const;
+        glm::dmat3 const& getInvViewMatrix() const;
 
         void setScreenSize(unsigned int screenWidth, unsigned int screenHeight);
-        void setOrigin (glm::vec2 const& newOrigin);
-        void setZoomLevel (float newZoomLevel);
+        void setOrigin (glm::dvec2 const& newOrigin);
+        void setZoomLevel (double newZoomLevel);
+
+        /* Scales the view by 1+factor about towards, which stays where it is in the window.
+         * The view is only kept as its origin and zoom level, from which the matrix is computed again:
+         * repeated zooms don't accumulate the rounding of matrix products.
+         */
+        void zoom (glm::dvec2 const& towards, double factor);
 
-        void zoom (glm::vec2 const& towards, float factor);
+        /* Moves by whole pixels of the screen, rounding the movement to the nearest.
+         * Only the pan from the anchor changes: pixel positions computed from the anchor
+         * stay the same, so that the CPU engine only computes the pixels the movement exposed.
+         * Any other change of the view anchors it on its origin again.
+         */
         void relativeMovement (glm::vec2 const& movement);
 
-        glm::vec2 windowToWorld (glm::vec2 const& winPos);
+        glm::dvec2 windowToWorld (glm::vec2 const& winPos) const;
 
     private:
+        void setAnchor (glm::dvec2 const& anchor);
         void computeInvViewMatrix();
 
 
     private:
-        glm::vec2 _origin; //absolute coordinates
-        float _zoomLevel;
-        float _aspectRatio;
+        glm::dvec2 _origin; //absolute coordinates
+        glm::dvec2 _anchor;
+        glm::ivec2 _panPixels;
+        double _zoomLevel;
+        double _aspectRatio;
+        unsigned int _screenHeight;
 
-        glm::mat3 _invViewMatrix;
+        glm::dmat3 _invViewMatrix;
 };
 
 #endif // CAMERA_HPP_INCLUDED
@@ -1,23 +1,36 @@
 #ifndef FRACTAL_HPP_INCLUDED
 #define FRACTAL_HPP_INCLUDED
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include <GL/glew.h>
 #include "glm.hpp"
 #include <SFML/OpenGL.hpp>
 
 #include <SFML/Graphics/Shader.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Clock.hpp>
 #include <SFML/Window/Event.hpp>
 #include <SFML/Window/Window.hpp>
 
 #include "Camera.hpp"
+#include "FractalType.hpp"
+#include "GPUTimer.hpp"
+#include "cpu/CPURenderer.hpp"
+#include "cpu/IterationBuffer.hpp"
+#include "cpu/OrbitCache.hpp"
+#include "cpu/Palette.hpp"
+#include "cpu/PrecisionLadder.hpp"
+#include "cpu/Tile.hpp"
 
 
 /* Class for drawing Mandelbrot or Julia fractals */
 class Fractal
 {
     public:
-        enum class Type{Mandelbrot, Julia};
+        typedef FractalType Type;
 
     public:
         Fractal(Fractal::Type type, std::string const& palette);
@@ -25,7 +38,20 @@ class Fractal
 
         bool needToRedraw() const;
 
-        /* Draws to the current active OpenGL context */
+        /* True while the CPU engine or the progressive and tiled GPU modes are refining the last frame, see draw() */
+        bool isRefining() const;
+
+        /* Draws to the current active OpenGL context.
+         * Both engines keep the iteration counts of the last frame: a draw that follows no change of the view
+         * or of maxIter, like one for the palette or for the text over the fractal, only colors them again.
+         * On the GPU, the fractal shader writes the counts to a float texture, that coloring.frag maps to the palette.
+         * With CPU rendering, a new frame is first drawn at 1/8 resolution: the following draws
+         * refine it to 1/4, 1/2 then full resolution, reusing the pixels already computed.
+         * A complete frame that is only panned is shifted instead, and only the exposed strips are computed.
+         * Other moves first show the last frame resampled under the new view, then compute it again
+         * tile by tile, starting with the tiles where the resampling is the least accurate.
+         * A change of maxIter alone only iterates further the pixels that had not escaped, see OrbitCache.
+         */
         void draw () const;
 
         void saveToFile (std::string const& filepath) const;
@@ -37,21 +63,148 @@ class Fractal
         void setMaxIter(unsigned int maxIter);
         unsigned int getMaxIter() const;
 
-        void setSeed (glm::vec2 seed);
+        void setSeed (glm::dvec2 seed);
+
+        /* Loads the palette from an image file, whose first row is used */
+        void setPalette (std::string const& palette);
+        std::string const& getPalette() const;
+
+        /* Shifts the palette continuously over the points that escaped */
+        void setPaletteCycling (bool paletteCycling);
+        bool isPaletteCycling() const;
+
+        /* Colors the continuous iteration counts of the GPU instead of showing bands.
+         * The CPU engine only has whole counts.
+         */
+        void setSmoothColoring (bool smoothColoring);
+        bool isSmoothColoring() const;
+
+        /* Computes the fractal with the CPU engine instead of the fragment shader */
+        void setCPURendering (bool cpuRendering);
+        bool isCPURendering() const;
+
+        /* Runs the GPU iterations a slice at a time, one slice per draw, so that each draw stays short
+         * whatever maxIter: the orbits are kept in textures, see mandelbrot_progressive.frag
+         */
+        void setProgressiveGPU (bool progressiveGPU);
+        bool isProgressiveGPU() const;
+
+        /* Draws a new GPU frame tile by tile, as many tiles per draw as the GPU timings suggest fit
+         * in a short time budget, so that no draw stalls the driver. Tiles not drawn yet keep the last frame.
+         * The progressive mode takes precedence.
+         */
+        void setTiledGPU (bool tiledGPU);
+        bool isTiledGPU() const;
+
+        /* How the CPU engine fills its tiles */
+        void setRenderMode (RenderMode mode);
+        RenderMode getRenderMode() const;
 
         std::string getInfoString() const;
 
+    private:
+        void loadPalette (std::string const& palette);
+
+        void drawGPU (bool newFrame) const;
+
+        /* Renders the iteration counts of the tiles of the viewport to _iterationsTextureID */
+        void drawIterationsGPU (GLint const* viewport, std::vector<Tile> const& tiles) const;
+
+        /* Renders the next tiles of _gpuTiles that fit in the time budget */
+        void drawTilesGPU (GLint const* viewport) const;
+
+        /* Runs the next slice of iterations of the orbits, and writes their counts to _iterationsTextureID.
+         * The orbits start over for a new view, and carry on when only maxIter changed.
+         */
+        void stepIterationsGPU (bool newFrame, GLint const* viewport) const;
+
+        /* Sets the uniforms the fractal shaders share, for shaders computing in precision */
+        void setFractalUniforms (GLuint shaderHandle, GLint const* viewport, Precision precision) const;
+        void drawCPU (bool newFrame) const;
+
+        /* Brings the last frame, if complete and of the same view, to the new maxIter */
+        bool resumeFrame (RenderParameters const& parameters) const;
+
+        /* Resamples the last frame under the new view if it covers enough of it, see reproject() */
+        bool drawPreview (RenderParameters const& parameters) const;
+
+        /* Renders the next tiles of the preview that fit in the time budget */
+        void refinePreview (RenderParameters const& parameters) const;
+
+        /* Draws the viewport-covering quad with the given bound shader */
+        void drawCorners (GLuint shaderHandle) const;
+
     private:
         Type _type; //either mandelbrot or julia
-        glm::vec2 _seed;
+        glm::dvec2 _seed;
         unsigned int _maxIter;
 
         GLuint _cornersBufferID;
         sf::Texture _palette;
+        std::string _paletteFile;
 
         Camera _camera;
         mutable bool _needToRedraw;
+        mutable bool _needToRecolor; //only the coloring changed since the last draw
         mutable sf::Shader _shader;
+
+        /* Variant of _shader for the views too deep for floats, in native doubles if the GPU has them,
+         * otherwise in double-floats: _gpuPrecision picks one or the other for each draw
+         */
+        mutable sf::Shader _deepShader;
+        mutable PrecisionLadder _gpuPrecision;
+
+        /* Coloring of the iteration counts */
+        bool _paletteCycling;
+        mutable float _paletteOffset; //see coloring.frag
+        mutable sf::Clock _paletteClock; //time since the last shift of the palette
+        bool _smoothColoring;
+
+        /* Iteration counts of the GPU, one R32F texel per pixel of the viewport */
+        GLuint _iterationsTextureID;
+        mutable unsigned int _iterationsWidth;
+        mutable unsigned int _iterationsHeight;
+        mutable sf::Shader _coloringShader;
+
+        /* Progressive iteration on the GPU: orbits in ping-pong textures, see stepIterationsGPU() */
+        bool _progressiveGPU;
+        mutable sf::Shader _progressiveShader;
+        GLuint _orbitsTextureIDs[2]; //z, iterations and status
+        GLuint _cyclesTextureIDs[2]; //state of the cycle detection
+        mutable unsigned int _orbitsSource; //index of the textures holding the orbits
+        mutable RenderParameters _orbitsParameters;
+        mutable unsigned int _orbitsIterations; //iterations run so far by the orbits that can still escape, 0 if no orbits
+
+        /* Tiled GPU mode, see drawTilesGPU() */
+        bool _tiledGPU;
+        mutable std::vector<Tile> _gpuTiles; //still to draw, the ones closest to the center first
+        mutable GPUTimer _gpuTimer;
+        mutable double _gpuTimedPixels; //pixels of the tiles _gpuTimer measures
+        mutable double _gpuPixelsPerSecond; //of the last measure
+
+        /* CPU rendering */
+        bool _cpuRendering;
+        std::unique_ptr<EscapeTimeKernel> _floatKernel;
+        std::unique_ptr<EscapeTimeKernel> _doubleKernel;
+        std::unique_ptr<EscapeTimeKernel> _doubleDoubleKernel;
+        std::unique_ptr<EscapeTimeKernel> _fixedPointKernel;
+        mutable PrecisionLadder _cpuPrecision; //kernel of the renderer, picked for each frame by drawCPU()
+        mutable CPURenderer _renderer;
+        Palette _cpuPalette;
+        mutable IterationBuffer _iterations;
+        mutable std::vector<std::uint8_t> _rgba;
+        mutable sf::Texture _image;
+        mutable sf::Shader _imageShader;
+        mutable unsigned int _passStep; //step of the last progressive pass, see RenderParameters::step
+        mutable unsigned int _nextPassStep; //0 once the frame is complete
+        mutable double _fullPassSeconds; //duration of the last full-resolution pass, 0 if none
+        mutable RenderParameters _frameParameters; //of the last frame, see findPan() and reproject()
+        mutable bool _frameValid; //_iterations holds the last frame, and its render mode is still the current one
+        mutable Precision _framePrecision; //of the kernel that rendered the last frame
+        mutable IterationBuffer _previousIterations; //source of the preview
+        mutable std::vector<Tile> _pendingTiles; //tiles of the preview still to render, worst first
+        mutable double _pixelsPerSecond; //of the last refinement of a preview
+        mutable OrbitCache _orbits; //filled when maxIter changes, see resumeFrame()
 };
 
 #endif // FRACTAL_HPP_INCLUDED
@@ -0,0 +1,7 @@
+#ifndef FRACTALTYPE_HPP_INCLUDED
+#define FRACTALTYPE_HPP_INCLUDED
+
+/* Kind of fractal: shared by the GPU (Fractal) and CPU (FractalRenderer) paths */
+enum class FractalType{Mandelbrot, Julia};
+
+#endif // FRACTALTYPE_HPP_INCLUDED
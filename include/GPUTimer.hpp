@@ -0,0 +1,41 @@
+#ifndef GPUTIMER_HPP_INCLUDED
+#define GPUTIMER_HPP_INCLUDED
+
+#include <GL/glew.h>
+#include <SFML/OpenGL.hpp>
+#include <SFML/System/Clock.hpp>
+
+
+/* Measures how long the commands issued between start() and stop() take to complete, as seen by the CPU,
+ * without waiting for them: a fence (GL_ARB_sync) tells when they completed, see poll().
+ * The measure ends when it is polled, so it is an upper bound. Without fences, stop() waits for the commands.
+ * Timer queries would measure the GPU time itself, but Mesa's llvmpipe reports meaningless ones.
+ */
+class GPUTimer
+{
+    public:
+        GPUTimer();
+        ~GPUTimer();
+
+        GPUTimer (GPUTimer const&) = delete;
+        GPUTimer& operator= (GPUTimer const&) = delete;
+
+        /* Only one measure runs at once, see isPending() */
+        void start();
+        void stop();
+
+        /* True while the last measure is not known yet */
+        bool isPending() const;
+
+        /* Returns true once the last measure is known, and then gives it, in seconds, only once */
+        bool poll (double& seconds);
+
+    private:
+        bool _fences; //GL_ARB_sync is available
+        GLsync _fence;
+        sf::Clock _clock;
+        double _seconds; //without fences, known as soon as stop() returns
+        bool _pending;
+};
+
+#endif // GPUTIMER_HPP_INCLUDED
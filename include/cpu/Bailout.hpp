@@ -0,0 +1,35 @@
+#ifndef BAILOUT_HPP_INCLUDED
+#define BAILOUT_HPP_INCLUDED
+
+#include "cpu/DoubleDouble.hpp"
+
+/* Escape test shared by all kernels: z escaped once |z|² > 4.
+ * Helpers are static so that the vectorized translation units, built with wider
+ * instruction sets, keep their own copies.
+ */
+
+
+/* The escape test can be skipped for several iterations, then done on the last one only,
+ * when |c| <= 1.9: once |z| > 2, |z'| >= |z|² - |c| > 2.1 so the orbit then only grows,
+ * with enough margin for rounding errors, and the escape is still visible at the end of the block
+ * (as a large value, an infinity or a NaN).
+ */
+template<typename T>
+static inline bool canDeferBailout (T cx, T cy)
+{
+    return cx * cx + cy * cy <= T(3.61);
+}
+
+/* The high parts are close enough: the bound has margin to spare */
+static inline bool canDeferBailout (DoubleDouble cx, DoubleDouble cy)
+{
+    return canDeferBailout(cx.hi, cy.hi);
+}
+
+/* Block sizes supported by the kernels, 1 meaning a test at each iteration */
+static inline bool isSupportedBailoutInterval (unsigned int interval)
+{
+    return interval == 1 || interval == 4 || interval == 8 || interval == 16;
+}
+
+#endif // BAILOUT_HPP_INCLUDED
@@ -0,0 +1,17 @@
+#ifndef BOUNDARYTRACE_HPP_INCLUDED
+#define BOUNDARYTRACE_HPP_INCLUDED
+
+#include "cpu/Tile.hpp"
+#include "cpu/TileContext.hpp"
+
+
+/* Boundary tracing, as in Fractint. The edge of the tile is computed first.
+ * Wherever two neighbouring pixels have different iteration counts, the pixels around them are
+ * computed too, so that the contour of every region is followed, 4x4 pixels at a time.
+ * What remains are areas enclosed by a contour of a single count, which are filled without iterating.
+ * The iteration bands are connected, so the result equals a brute-force render,
+ * unless a structure thinner than a pixel never comes close enough to a contour to be found.
+ */
+void renderBoundaryTrace (TileContext const& context, Tile const& tile);
+
+#endif // BOUNDARYTRACE_HPP_INCLUDED
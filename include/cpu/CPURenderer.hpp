@@ -0,0 +1,103 @@
+#ifndef CPURENDERER_HPP_INCLUDED
+#define CPURENDERER_HPP_INCLUDED
+
+#include <vector>
+
+#include "cpu/EscapeTimeKernel.hpp"
+#include "cpu/FractalRenderer.hpp"
+#include "cpu/ThreadPool.hpp"
+#include "cpu/Tile.hpp"
+#include "cpu/TileContext.hpp"
+
+
+/* How each tile is filled */
+enum class RenderMode
+{
+    BruteForce, //every pixel is computed
+    MarianiSilver, //rectangles with a uniform border are filled, see MarianiSilver.hpp
+    BoundaryTrace, //regions are traced along their contour then filled, see BoundaryTrace.hpp
+    SolidGuessing, //sparse samples, blocks whose corners agree are filled, see SolidGuessing.hpp
+    DistanceCulling //sparse samples, disks known to be outside the set are filled, see DistanceCulling.hpp
+};
+
+char const* getRenderModeName (RenderMode mode);
+
+/* CPU renderer: the image is split in square tiles, which a work-stealing
+ * thread pool hands to the render mode, which in turn calls the kernel.
+ * With RenderParameters::intervalCheck, a tile is classified first, then its quadrants,
+ * and only the rectangles that couldn't be proven uniform go to the render mode.
+ * With RenderParameters::symmetryCheck, the pixels that mirror others are left out of the tiles,
+ * and copied once the rest is rendered.
+ * Progressive passes (RenderParameters::step) go through the classifier, but not the render mode.
+ * Both mirrors and progressive passes need the whole frame: they are not used to fill parts of it.
+ */
+class CPURenderer : public FractalRenderer
+{
+    public:
+        /* The kernel is not owned and must outlive the renderer.
+         * threadCount 0 means one thread per hardware thread.
+         */
+        explicit CPURenderer (EscapeTimeKernel const& kernel, unsigned int threadCount=0);
+
+        void setKernel (EscapeTimeKernel const& kernel);
+        EscapeTimeKernel const& getKernel() const;
+
+        void setThreadCount (unsigned int threadCount);
+        unsigned int getThreadCount() const;
+
+        void setTileSize (unsigned int tileSize);
+        unsigned int getTileSize() const;
+
+        void setRenderMode (RenderMode mode);
+        RenderMode getRenderMode() const;
+
+        /* If not null, the rendered pixels of culled are set to 1 where distance culling filled them
+         * from an estimate, so that their counts may be off by one (see DistanceCulling.hpp), and to 0 elsewhere.
+         * culled is not owned, and has the size of the rendered buffers. Meant for checks, see the bench.
+         */
+        void setCulledPixels (IterationBuffer* culled);
+
+    protected:
+        virtual void doRender (RenderParameters const& parameters, std::vector<Tile> const& areas,
+                               IterationBuffer& buffer, RenderStats& stats);
+
+        virtual void doResume (RenderParameters const& parameters, PixelMapping const& mapping,
+                               Orbit* orbits, std::size_t count, RenderStats& stats);
+
+    private:
+        void renderTile (TileContext const& context, Tile const& tile) const;
+
+        /* Rectangle of a progressive pass, see RenderParameters::step: the render mode is not used */
+        void renderCoarseRectangle (TileContext const& context, Tile const& rectangle) const;
+
+        /* Fills the tile if the interval classifier proves it uniform */
+        bool fillIfUniform (TileContext const& context, Tile const& tile) const;
+
+        /* Fills the rectangle with the current render mode */
+        void renderRectangle (TileContext const& context, Tile const& rectangle) const;
+
+    private:
+        /* State of a worker, written at each pixel: the padding keeps the states of two workers
+         * off the same cache line, whatever the heap alignment
+         */
+        struct Worker
+        {
+            RenderStats stats;
+            std::vector<Pixel> pixels;
+            std::vector<std::uint8_t> flags;
+            std::vector<DistanceEstimate> estimates;
+            char padding[64];
+        };
+
+    private:
+        EscapeTimeKernel const* _kernel;
+        unsigned int _tileSize;
+        RenderMode _mode;
+        IterationBuffer* _culled;
+
+        std::unique_ptr<ThreadPool> _pool;
+
+        std::vector<Worker> _workers;
+};
+
+#endif // CPURENDERER_HPP_INCLUDED
@@ -0,0 +1,24 @@
+#ifndef DISTANCECULLING_HPP_INCLUDED
+#define DISTANCECULLING_HPP_INCLUDED
+
+#include "cpu/Tile.hpp"
+#include "cpu/TileContext.hpp"
+
+
+/* Exterior distance estimation. The tile is sampled on grids of decreasing step, and each
+ * escaped sample comes with a lower bound d of its distance to the set (Koebe 1/4 theorem):
+ * the disk of radius d/4 around it is filled from the sample's smooth count and gradient, without iterating.
+ * Within that disk, Harnack's inequality bounds the change of the smooth count to log2(5/3) < 0.74,
+ * and the extrapolation is clamped to that, so the filled smooth count is off by less than 1.5.
+ * Iteration counts are then off by one for most filled pixels, but escaping at iteration n
+ * is not quite a level set of the smooth count: a few are off by maxCulledError, most of them
+ * at the lowest counts.
+ * The bound needs a format that resolves the pixels of the view, see PrecisionLadder.
+ * Julia sets are only culled when connected, the bound not holding otherwise.
+ */
+void renderDistanceCulling (TileContext const& context, Tile const& tile);
+
+/* Largest difference between the count of a filled pixel and the count computing it gives */
+const unsigned int maxCulledError = 2;
+
+#endif // DISTANCECULLING_HPP_INCLUDED
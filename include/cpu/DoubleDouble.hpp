@@ -0,0 +1,107 @@
+#ifndef DOUBLEDOUBLE_HPP_INCLUDED
+#define DOUBLEDOUBLE_HPP_INCLUDED
+
+#include <cmath>
+
+
+/* Unevaluated sum hi + lo of two doubles, |lo| <= ulp(hi) / 2: about 106 bits of mantissa,
+ * the format of the kernels past the resolution of doubles.
+ * Operations are built on error-free transforms, which give the exact rounding error of a double
+ * operation as another double. Like in Bailout.hpp, helpers are static so that the vectorized
+ * translation units keep their own copies, and the type has no constructor for the same reason.
+ */
+struct DoubleDouble
+{
+    double hi;
+    double lo;
+};
+
+
+/* Constants and conversions in the formats of the kernels: float, double or DoubleDouble */
+template<typename T>
+static inline T toReal (double value)
+{
+    return static_cast<T>(value);
+}
+
+template<>
+inline DoubleDouble toReal<DoubleDouble> (double value)
+{
+    return DoubleDouble{value, 0.0};
+}
+
+static inline double toDouble (float value)
+{
+    return value;
+}
+
+static inline double toDouble (double value)
+{
+    return value;
+}
+
+static inline double toDouble (DoubleDouble value)
+{
+    return value.hi + value.lo;
+}
+
+
+/* a + b = hi + lo exactly (Knuth) */
+static inline DoubleDouble twoSum (double a, double b)
+{
+    const double s = a + b;
+    const double bb = s - a;
+    return DoubleDouble{s, (a - (s - bb)) + (b - bb)};
+}
+
+/* Same as twoSum, if |a| >= |b| (Dekker) */
+static inline DoubleDouble quickTwoSum (double a, double b)
+{
+    const double s = a + b;
+    return DoubleDouble{s, b - (s - a)};
+}
+
+/* a * b = hi + lo exactly: the fused multiply-add rounds a * b - hi only once, and it is representable */
+static inline DoubleDouble twoProduct (double a, double b)
+{
+    const double p = a * b;
+    return DoubleDouble{p, std::fma(a, b, -p)};
+}
+
+static inline DoubleDouble operator+ (DoubleDouble a, DoubleDouble b)
+{
+    DoubleDouble s = twoSum(a.hi, b.hi);
+    const DoubleDouble t = twoSum(a.lo, b.lo);
+    s = quickTwoSum(s.hi, s.lo + t.hi);
+    return quickTwoSum(s.hi, s.lo + t.lo);
+}
+
+static inline DoubleDouble operator- (DoubleDouble a)
+{
+    return DoubleDouble{-a.hi, -a.lo};
+}
+
+static inline DoubleDouble operator- (DoubleDouble a, DoubleDouble b)
+{
+    return a + (-b);
+}
+
+/* The lo * lo term is below the precision of the result */
+static inline DoubleDouble operator* (DoubleDouble a, DoubleDouble b)
+{
+    const DoubleDouble p = twoProduct(a.hi, b.hi);
+    return quickTwoSum(p.hi, p.lo + (a.hi * b.lo + a.lo * b.hi));
+}
+
+/* False if either is a NaN, as for doubles */
+static inline bool operator<= (DoubleDouble a, DoubleDouble b)
+{
+    return a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo);
+}
+
+static inline bool operator> (DoubleDouble a, DoubleDouble b)
+{
+    return b.hi < a.hi || (a.hi == b.hi && a.lo > b.lo);
+}
+
+#endif // DOUBLEDOUBLE_HPP_INCLUDED
@@ -0,0 +1,111 @@
+#ifndef DOUBLEDOUBLELANES_HPP_INCLUDED
+#define DOUBLEDOUBLELANES_HPP_INCLUDED
+
+/* Double-double lanes built on the double lanes D of an instruction set, for EscapeTimeSIMDImpl.hpp.
+ * Only to be included by the EscapeTime<ISA>.cpp files, after the definition of D, which also provides
+ * productError(a, b, p): the exact a * b - p when p is the rounded a * b.
+ * Operations are those of DoubleDouble.hpp, in the same order, so that results are bit-identical.
+ */
+
+#include <cstddef>
+
+#include "cpu/DoubleDouble.hpp"
+
+
+namespace
+{
+
+template<class D>
+struct DoubleDoubleLanes
+{
+    typedef DoubleDouble Real;
+    typedef typename D::Vec Part;
+    struct Vec
+    {
+        Part hi;
+        Part lo;
+    };
+    typedef typename D::Mask Mask;
+    typedef typename D::Counter Counter;
+    static const std::size_t Width = D::Width;
+
+    static Vec load (DoubleDouble const* p)
+    {
+        alignas(64) double hi[Width], lo[Width];
+        for (std::size_t i = 0; i < Width; ++i) {
+            hi[i] = p[i].hi;
+            lo[i] = p[i].lo;
+        }
+        return Vec{D::load(hi), D::load(lo)};
+    }
+
+    static void storeReal (Vec v, DoubleDouble* p)
+    {
+        alignas(64) double hi[Width], lo[Width];
+        D::storeReal(v.hi, hi);
+        D::storeReal(v.lo, lo);
+        for (std::size_t i = 0; i < Width; ++i) {
+            p[i] = DoubleDouble{hi[i], lo[i]};
+        }
+    }
+
+    static Vec set1 (DoubleDouble v) { return Vec{D::set1(v.hi), D::set1(v.lo)}; }
+
+    static Vec twoSum (Part a, Part b)
+    {
+        const Part s = D::add(a, b);
+        const Part bb = D::sub(s, a);
+        return Vec{s, D::add(D::sub(a, D::sub(s, bb)), D::sub(b, bb))};
+    }
+
+    static Vec quickTwoSum (Part a, Part b)
+    {
+        const Part s = D::add(a, b);
+        return Vec{s, D::sub(b, D::sub(s, a))};
+    }
+
+    static Vec add (Vec a, Vec b)
+    {
+        Vec s = twoSum(a.hi, b.hi);
+        const Vec t = twoSum(a.lo, b.lo);
+        s = quickTwoSum(s.hi, D::add(s.lo, t.hi));
+        return quickTwoSum(s.hi, D::add(s.lo, t.lo));
+    }
+
+    /* -0 - x flips the sign of zeros too */
+    static Vec sub (Vec a, Vec b)
+    {
+        const Part minusZero = D::set1(-0.0);
+        return add(a, Vec{D::sub(minusZero, b.hi), D::sub(minusZero, b.lo)});
+    }
+
+    static Vec mul (Vec a, Vec b)
+    {
+        const Part p = D::mul(a.hi, b.hi);
+        const Part cross = D::add(D::mul(a.hi, b.lo), D::mul(a.lo, b.hi));
+        return quickTwoSum(p, D::add(D::productError(a.hi, b.hi, p), cross));
+    }
+
+    static Mask lessEqual (Vec a, Vec b)
+    {
+        const Mask notAbove = D::maskOr(D::maskAndNot(D::allLanes(), D::lessEqual(b.hi, a.hi)), D::lessEqual(a.lo, b.lo));
+        return D::maskAnd(D::lessEqual(a.hi, b.hi), notAbove);
+    }
+
+    static Mask maskAnd (Mask a, Mask b) { return D::maskAnd(a, b); }
+    static Mask maskOr (Mask a, Mask b) { return D::maskOr(a, b); }
+    static Mask maskAndNot (Mask a, Mask b) { return D::maskAndNot(a, b); }
+    static bool any (Mask m) { return D::any(m); }
+    static unsigned int bits (Mask m) { return D::bits(m); }
+    static Mask allLanes() { return D::allLanes(); }
+    static Mask noLanes() { return D::noLanes(); }
+
+    static Counter zeroCounter() { return D::zeroCounter(); }
+    static Counter increment (Counter c, Mask m) { return D::increment(c, m); }
+    static Counter incrementBy (Counter c, Mask m, unsigned int n) { return D::incrementBy(c, m, n); }
+    static void store (Counter c, unsigned int* out) { D::store(c, out); }
+};
+
+}
+
+#endif // DOUBLEDOUBLELANES_HPP_INCLUDED
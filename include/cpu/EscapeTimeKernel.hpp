@@ -0,0 +1,101 @@
+#ifndef ESCAPETIMEKERNEL_HPP_INCLUDED
+#define ESCAPETIMEKERNEL_HPP_INCLUDED
+
+#include <cstddef>
+
+#include "cpu/IterationBuffer.hpp"
+#include "cpu/RenderParameters.hpp"
+#include "cpu/RenderStats.hpp"
+
+
+struct Pixel
+{
+    unsigned int x;
+    unsigned int y;
+};
+
+
+/* Where the orbit of a pixel stopped, see EscapeTimeKernel::resume() */
+struct Orbit
+{
+    Pixel pixel;
+    unsigned int iter; //iterations run so far, 0 if the orbit has not started
+    bool interior; //found in the main cardioid or periodic: it never escapes
+    double zx, zy; //z after iter iterations, exact for the float kernels too
+    double zxLo, zyLo; //low parts of z for the double-double kernels, 0 for the others
+    double zxTail, zyTail; //with the low parts, what the fixed-point kernel needs for its 120 fraction bits
+};
+
+
+/* What the derivative of the orbit tells about an escaped pixel, see EscapeTimeKernel::computeDistances() */
+struct DistanceEstimate
+{
+    DistanceEstimate():
+        distance(0.0),
+        smoothIter(0.0),
+        gradient(0.0, 0.0)
+    {}
+
+    /* Lower bound of the distance to the set, in world units (Koebe 1/4 theorem),
+     * 0 for the pixels that didn't escape */
+    double distance;
+
+    /* Continuous iteration count n - log2(ln|z_n|) of the smooth coloring, but taken far enough
+     * along the orbit to be -log2 of the Green function, and its gradient per world unit */
+    double smoothIter;
+    glm::dvec2 gradient;
+};
+
+
+/* True if c lies in the main cardioid or in the period-2 bulb of the Mandelbrot set,
+ * where orbits never escape.
+ * Double-double kernels test it in double too: the points it can misjudge lie within about 1e-15
+ * of the boundary, and take some 1e8 iterations to escape.
+ */
+inline bool isInCardioidOrBulb (glm::dvec2 const& c)
+{
+    const double x = c.x - 0.25, y2 = c.y * c.y;
+    const double q = x * x + y2;
+    if (q * (q + x) <= 0.25 * y2)
+        return true;
+
+    return (c.x + 1.0) * (c.x + 1.0) + y2 <= 0.0625;
+}
+
+
+/* Computes the escape time of pixels, the CPU equivalent of the fragment shaders:
+ *   z = pixel position, c = pixel position (Mandelbrot) or seed (Julia)
+ *   while (iter < maxIter && |z| <= 2) { z = z² + c; ++iter; }
+ * Kernels must be stateless so that one instance can be shared by all threads,
+ * and honor the cardioid and periodicity checks of RenderParameters.
+ */
+class EscapeTimeKernel
+{
+    public:
+        virtual ~EscapeTimeKernel() {}
+
+        virtual char const* getName() const = 0;
+
+        /* Writes the iteration count of each listed pixel to buffer */
+        virtual void compute (RenderParameters const& parameters, PixelMapping const& mapping,
+                              Pixel const* pixels, std::size_t count,
+                              IterationBuffer& buffer, RenderStats& stats) const = 0;
+
+        /* Same as compute(), with the same counts, and also writes the distance estimate of each pixel.
+         * The derivative dz/dc (or dz/dz0 for Julia) is carried along z, at the cost of vectorization.
+         */
+        virtual void computeDistances (RenderParameters const& parameters, PixelMapping const& mapping,
+                                       Pixel const* pixels, std::size_t count,
+                                       IterationBuffer& buffer, DistanceEstimate* estimates,
+                                       RenderStats& stats) const = 0;
+
+        /* Iterates each orbit further, from its z, until it escapes or reaches parameters.maxIter,
+         * and updates it: an orbit that escaped ends with iter below maxIter.
+         * Counts are those compute() gives, but cycle detection starts over from z, so an interior
+         * pixel may take longer to be found periodic.
+         */
+        virtual void resume (RenderParameters const& parameters, PixelMapping const& mapping,
+                             Orbit* orbits, std::size_t count, RenderStats& stats) const = 0;
+};
+
+#endif // ESCAPETIMEKERNEL_HPP_INCLUDED
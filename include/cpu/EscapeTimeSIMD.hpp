@@ -0,0 +1,65 @@
+#ifndef ESCAPETIMESIMD_HPP_INCLUDED
+#define ESCAPETIMESIMD_HPP_INCLUDED
+
+#include <cstddef>
+
+#include "cpu/DoubleDouble.hpp"
+
+
+/* Entry points of the vectorized escape-time loops, one translation unit per instruction set.
+ * They only exchange plain arrays with the rest of the engine, so that no code compiled
+ * for a wide instruction set can end up being called on a CPU that lacks it.
+ */
+
+template<typename T>
+struct SIMDInput
+{
+    T const* x; //starting points z0
+    T const* y;
+    std::size_t count;
+
+    bool julia; //c = seed if true, else c = z0
+    T seedX, seedY;
+
+    /* Resumed orbits, see EscapeTimeKernel::resume(): if not null, c of point i is (cx[i], cy[i])
+     * instead of its starting point (Mandelbrot only)
+     */
+    T const* cx;
+    T const* cy;
+
+    /* If not null, receive the z where the orbit of each point stopped */
+    T* lastX;
+    T* lastY;
+
+    unsigned int maxIter;
+
+    /* If true, a lane is given the next pending point as soon as its point is done,
+     * instead of waiting for the slowest lane of the batch.
+     */
+    bool refillLanes;
+
+    /* 1 to test for escape at each iteration, or 4, 8 or 16 to test once per block of iterations */
+    unsigned int bailoutInterval;
+
+    /* Brent cycle detection, tolerance2 being the squared distance under which points are equal */
+    bool periodicityCheck;
+    T tolerance2;
+};
+
+/* Each function writes, for every input point, the number of iterations run
+ * and whether its orbit was found periodic (in which case it is interior).
+ */
+
+void escapeTimeSSE2 (SIMDInput<float> const& input, unsigned int* iterations, bool* periodic);
+void escapeTimeSSE2 (SIMDInput<double> const& input, unsigned int* iterations, bool* periodic);
+void escapeTimeSSE2 (SIMDInput<DoubleDouble> const& input, unsigned int* iterations, bool* periodic);
+
+void escapeTimeAVX2 (SIMDInput<float> const& input, unsigned int* iterations, bool* periodic);
+void escapeTimeAVX2 (SIMDInput<double> const& input, unsigned int* iterations, bool* periodic);
+void escapeTimeAVX2 (SIMDInput<DoubleDouble> const& input, unsigned int* iterations, bool* periodic);
+
+void escapeTimeAVX512 (SIMDInput<float> const& input, unsigned int* iterations, bool* periodic);
+void escapeTimeAVX512 (SIMDInput<double> const& input, unsigned int* iterations, bool* periodic);
+void escapeTimeAVX512 (SIMDInput<DoubleDouble> const& input, unsigned int* iterations, bool* periodic);
+
+#endif // ESCAPETIMESIMD_HPP_INCLUDED
@@ -0,0 +1,373 @@
+#ifndef ESCAPETIMESIMDIMPL_HPP_INCLUDED
+#define ESCAPETIMESIMDIMPL_HPP_INCLUDED
+
+/* Generic vectorized escape-time loops.
+ * Only to be included by the EscapeTime<ISA>.cpp files, after the definition of their lane types.
+ * Everything lives in an anonymous namespace so that each instruction set keeps its own copy.
+ *
+ * A lane type V provides:
+ *   Real, Vec, Mask, Counter types and a Width constant (number of lanes)
+ *   load, storeReal, set1, add, sub, mul, lessEqual
+ *   (Real may be DoubleDouble, whose lanes are pairs of double vectors, see DoubleDoubleLanes.hpp)
+ *   maskAnd, maskOr, maskAndNot, any, allLanes, noLanes
+ *   bits(mask): one bit per lane, lane 0 being the lowest bit
+ *   zeroCounter, increment(counter, mask), incrementBy(counter, mask, n), store(counter, unsigned int*)
+ */
+
+#include <cstddef>
+
+#include "cpu/Bailout.hpp"
+#include "cpu/EscapeTimeSIMD.hpp"
+
+
+namespace
+{
+
+/* Iterations are done with the same operations, in the same order, as escapeTime(),
+ * so that results are bit-identical. x2 and y2 hold the squares of the current z.
+ */
+template<class V>
+inline void advance (typename V::Vec& zx, typename V::Vec& zy, typename V::Vec& x2, typename V::Vec& y2,
+                     typename V::Vec const& cx, typename V::Vec const& cy)
+{
+    zy = V::add(V::mul(V::add(zx, zx), zy), cy);
+    zx = V::add(V::sub(x2, y2), cx);
+    x2 = V::mul(zx, zx);
+    y2 = V::mul(zy, zy);
+}
+
+/* Lanes where z is within tolerance of the reference point, computed like CycleDetector */
+template<class V>
+inline typename V::Mask isNearReference (typename V::Vec const& zx, typename V::Vec const& zy,
+                                         typename V::Vec const& refX, typename V::Vec const& refY,
+                                         typename V::Vec const& tolerance2)
+{
+    typename V::Vec dx = V::sub(zx, refX), dy = V::sub(zy, refY);
+    return V::lessEqual(V::add(V::mul(dx, dx), V::mul(dy, dy)), tolerance2);
+}
+
+/* All lanes of a batch iterate until the slowest one is done.
+ * With N > 1, the escape test is only done every N iterations, see canDeferBailout().
+ * When a lane escaped during a block, the block is replayed from its start with a test per iteration.
+ * With Periodic, cycles are detected like escapeTimePeriodic() does, after each iteration:
+ * escape tests are then not deferred, see escapeTimeDeferred().
+ */
+template<class V, unsigned int N, bool Periodic>
+void escapeTimeBatch (SIMDInput<typename V::Real> const& input, unsigned int* iterations, bool* periodic)
+{
+    typedef typename V::Real T;
+    typedef typename V::Vec Vec;
+    typedef typename V::Mask Mask;
+    typedef typename V::Counter Counter;
+
+    const Vec four = V::set1(toReal<T>(4.0));
+    const Vec tolerance2 = V::set1(input.tolerance2);
+    const Vec seedX = V::set1(input.seedX), seedY = V::set1(input.seedY);
+    const bool seedAllowsDeferring = canDeferBailout(input.seedX, input.seedY);
+
+    for (std::size_t first = 0; first < input.count; first += V::Width) {
+        const std::size_t n = (input.count - first < V::Width) ? input.count - first : V::Width;
+
+        /* Unused lanes start outside of the disk of radius 2, so they never count */
+        alignas(64) T x[V::Width], y[V::Width], pointX[V::Width], pointY[V::Width];
+        bool deferring = (N > 1) && !Periodic && (!input.julia || seedAllowsDeferring);
+        for (std::size_t i = 0; i < V::Width; ++i) {
+            x[i] = (i < n) ? input.x[first + i] : toReal<T>(4.0);
+            y[i] = (i < n) ? input.y[first + i] : toReal<T>(4.0);
+            pointX[i] = (i < n && input.cx) ? input.cx[first + i] : x[i];
+            pointY[i] = (i < n && input.cy) ? input.cy[first + i] : y[i];
+            if (!input.julia && i < n)
+                deferring = deferring && canDeferBailout(pointX[i], pointY[i]);
+        }
+
+        Vec zx = V::load(x), zy = V::load(y);
+        const Vec cx = input.julia ? seedX : V::load(pointX);
+        const Vec cy = input.julia ? seedY : V::load(pointY);
+
+        Vec x2 = V::mul(zx, zx), y2 = V::mul(zy, zy);
+        Mask active = V::lessEqual(V::add(x2, y2), four);
+        Counter count = V::zeroCounter();
+
+        Vec refX = zx, refY = zy;
+        unsigned int refSteps = 0, refPeriod = 1;
+        Mask returned = V::noLanes(); //lanes that came back near the reference point once
+        Mask cycled = V::noLanes();
+
+        unsigned int iter = 0;
+        while (iter < input.maxIter && V::any(active)) {
+            unsigned int checkedSteps = 1;
+
+            if (deferring && input.maxIter - iter >= N) {
+                const Vec savedX = zx, savedY = zy, savedX2 = x2, savedY2 = y2;
+                for (unsigned int i = 0; i < N; ++i) {
+                    advance<V>(zx, zy, x2, y2, cx, cy);
+                }
+
+                Mask stillActive = V::maskAnd(active, V::lessEqual(V::add(x2, y2), four));
+                if (V::bits(stillActive) == V::bits(active)) {
+                    count = V::incrementBy(count, active, N);
+                    iter += N;
+                    continue;
+                }
+
+                /* Rollback to the checkpoint */
+                zx = savedX;
+                zy = savedY;
+                x2 = savedX2;
+                y2 = savedY2;
+                checkedSteps = N;
+            }
+
+            for (unsigned int i = 0; i < checkedSteps && V::any(active); ++i) {
+                count = V::increment(count, active);
+                advance<V>(zx, zy, x2, y2, cx, cy);
+
+                if (Periodic) {
+                    Mask near = V::maskAnd(active, isNearReference<V>(zx, zy, refX, refY, tolerance2));
+                    Mask confirmed = V::maskAnd(near, returned);
+                    cycled = V::maskOr(cycled, confirmed);
+                    active = V::maskAndNot(active, confirmed);
+                    returned = V::maskOr(returned, near);
+                    if (++refSteps == refPeriod) {
+                        refSteps = 0;
+                        refPeriod *= 2;
+                        refX = zx;
+                        refY = zy;
+                        returned = V::noLanes();
+                    }
+                }
+
+                active = V::maskAnd(active, V::lessEqual(V::add(x2, y2), four));
+            }
+            iter += checkedSteps;
+        }
+
+        alignas(64) unsigned int counts[V::Width];
+        V::store(count, counts);
+        const unsigned int cycledBits = V::bits(cycled);
+        for (std::size_t i = 0; i < n; ++i) {
+            iterations[first + i] = counts[i];
+            periodic[first + i] = ((cycledBits >> i) & 1u) != 0;
+        }
+
+        /* Only meaningful for the lanes that reached maxIter: the others went on with the batch */
+        if (input.lastX) {
+            V::storeReal(zx, x);
+            V::storeReal(zy, y);
+            for (std::size_t i = 0; i < n; ++i) {
+                input.lastX[first + i] = x[i];
+                input.lastY[first + i] = y[i];
+            }
+        }
+    }
+}
+
+/* Streams the points through the lanes: a lane whose point escaped, was found periodic
+ * or reached maxIter is retired and reloaded with the next pending point, so results come out of order.
+ * Iteration counts are not kept in vectors: a lane's count is the number of steps
+ * since it was loaded, and the earliest lane to reach maxIter gives the next deadline.
+ * Deferred escape tests (N > 1) work as in escapeTimeBatch, blocks never crossing a deadline,
+ * and are not done with Periodic either.
+ * Each lane runs its own cycle detection, on the schedule of CycleDetector counted from the step
+ * it was loaded at: a newly loaded point is its own first reference, moved after 1, 2, 4... more steps.
+ */
+template<class V, unsigned int N, bool Periodic>
+void escapeTimeRefill (SIMDInput<typename V::Real> const& input, unsigned int* iterations, bool* periodic)
+{
+    typedef typename V::Real T;
+    typedef typename V::Vec Vec;
+
+    const Vec four = V::set1(toReal<T>(4.0));
+    const Vec tolerance2 = V::set1(input.tolerance2);
+    const unsigned long long maxIter = input.maxIter;
+
+    /* refX and refY always hold the reference points of zrefX and zrefY, which are only loaded from them */
+    alignas(64) T x[V::Width], y[V::Width], cx[V::Width], cy[V::Width], refX[V::Width], refY[V::Width];
+    std::size_t point[V::Width]; //index of the point held by each lane
+    unsigned long long start[V::Width]; //step at which it was loaded
+    unsigned long long refreshStep[V::Width], refreshPeriod[V::Width]; //next move of the reference point, and the one after
+    unsigned int live = 0; //one bit per lane holding a point
+    unsigned int undeferrable = 0; //one bit per live lane whose c forbids deferred tests
+    unsigned int returned = 0; //one bit per live lane that came back near its reference point once
+    unsigned int cycled = 0; //one bit per live lane found periodic
+
+    std::size_t next = 0;
+    unsigned long long step = 0;
+    unsigned int checkedSteps = 0; //steps left to test one by one after a rollback
+    unsigned long long nextRefresh = ~0ull; //earliest refreshStep of the live lanes
+
+    /* Dead lanes iterate from 0, which stays bounded */
+    for (std::size_t lane = 0; lane < V::Width; ++lane) {
+        x[lane] = y[lane] = cx[lane] = cy[lane] = refX[lane] = refY[lane] = toReal<T>(0.0);
+    }
+
+    Vec zx = V::load(x), zy = V::load(y);
+    Vec zcx = V::load(cx), zcy = V::load(cy);
+    Vec zrefX = V::load(refX), zrefY = V::load(refY);
+    Vec x2 = V::mul(zx, zx), y2 = V::mul(zy, zy);
+    unsigned long long deadline = step; //forces the initial load
+
+    while (true) {
+        unsigned int escaped = ~V::bits(V::lessEqual(V::add(x2, y2), four)) & live;
+
+        if (escaped != 0 || cycled != 0 || step == deadline) {
+            V::storeReal(zx, x);
+            V::storeReal(zy, y);
+            V::storeReal(zcx, cx);
+            V::storeReal(zcy, cy);
+
+            deadline = ~0ull;
+            nextRefresh = ~0ull;
+            for (std::size_t lane = 0; lane < V::Width; ++lane) {
+                const unsigned int bit = 1u << lane;
+                const bool done = ((live & bit) != 0) &&
+                        (step - start[lane] == maxIter || ((escaped | cycled) & bit) != 0);
+                if (done) {
+                    iterations[point[lane]] = static_cast<unsigned int>(step - start[lane]);
+                    periodic[point[lane]] = (cycled & bit) != 0;
+                    if (input.lastX) {
+                        input.lastX[point[lane]] = x[lane];
+                        input.lastY[point[lane]] = y[lane];
+                    }
+                }
+
+                if (done || (live & bit) == 0) {
+                    undeferrable &= ~bit;
+                    returned &= ~bit;
+                    if (next < input.count) {
+                        x[lane] = refX[lane] = input.x[next];
+                        y[lane] = refY[lane] = input.y[next];
+                        cx[lane] = input.julia ? input.seedX : (input.cx ? input.cx[next] : x[lane]);
+                        cy[lane] = input.julia ? input.seedY : (input.cy ? input.cy[next] : y[lane]);
+                        if (!canDeferBailout(cx[lane], cy[lane]))
+                            undeferrable |= bit;
+                        point[lane] = next++;
+                        start[lane] = step;
+                        refreshStep[lane] = step + 1;
+                        refreshPeriod[lane] = 2;
+                        live |= bit;
+                    } else {
+                        x[lane] = y[lane] = cx[lane] = cy[lane] = refX[lane] = refY[lane] = toReal<T>(0.0);
+                        live &= ~bit;
+                    }
+                }
+
+                if ((live & bit) != 0 && start[lane] + maxIter < deadline)
+                    deadline = start[lane] + maxIter;
+                if ((live & bit) != 0 && refreshStep[lane] < nextRefresh)
+                    nextRefresh = refreshStep[lane];
+            }
+            cycled = 0;
+
+            if (live == 0)
+                break;
+
+            zx = V::load(x);
+            zy = V::load(y);
+            zcx = V::load(cx);
+            zcy = V::load(cy);
+            zrefX = V::load(refX);
+            zrefY = V::load(refY);
+            x2 = V::mul(zx, zx);
+            y2 = V::mul(zy, zy);
+
+            /* The new points must be tested before their first step */
+            continue;
+        }
+
+        bool blockDone = false;
+        if (N > 1 && !Periodic && checkedSteps == 0 && undeferrable == 0 && step + N <= deadline) {
+            const Vec savedX = zx, savedY = zy, savedX2 = x2, savedY2 = y2;
+            for (unsigned int i = 0; i < N; ++i) {
+                advance<V>(zx, zy, x2, y2, zcx, zcy);
+            }
+
+            if ((~V::bits(V::lessEqual(V::add(x2, y2), four)) & live) == 0) {
+                step += N;
+                blockDone = true;
+            } else {
+                /* Rollback to the checkpoint */
+                zx = savedX;
+                zy = savedY;
+                x2 = savedX2;
+                y2 = savedY2;
+                checkedSteps = N;
+            }
+        }
+
+        if (!blockDone) {
+            advance<V>(zx, zy, x2, y2, zcx, zcy);
+            ++step;
+            if (checkedSteps > 0)
+                --checkedSteps;
+        }
+
+        if (Periodic) {
+            const unsigned int near = V::bits(isNearReference<V>(zx, zy, zrefX, zrefY, tolerance2)) & live;
+            cycled = near & returned;
+            returned |= near;
+            if (step >= nextRefresh) {
+                V::storeReal(zx, x);
+                V::storeReal(zy, y);
+
+                nextRefresh = ~0ull;
+                for (std::size_t lane = 0; lane < V::Width; ++lane) {
+                    if ((live & (1u << lane)) == 0)
+                        continue;
+
+                    if (step >= refreshStep[lane]) {
+                        refX[lane] = x[lane];
+                        refY[lane] = y[lane];
+                        returned &= ~(1u << lane);
+                        refreshStep[lane] = step + refreshPeriod[lane];
+                        refreshPeriod[lane] *= 2;
+                    }
+                    if (refreshStep[lane] < nextRefresh)
+                        nextRefresh = refreshStep[lane];
+                }
+
+                zrefX = V::load(refX);
+                zrefY = V::load(refY);
+            }
+        }
+    }
+}
+
+template<class V, unsigned int N>
+void escapeTimeSIMD (SIMDInput<typename V::Real> const& input, unsigned int* iterations, bool* periodic)
+{
+    if (input.refillLanes) {
+        if (input.periodicityCheck)
+            escapeTimeRefill<V, N, true>(input, iterations, periodic);
+        else
+            escapeTimeRefill<V, N, false>(input, iterations, periodic);
+    } else {
+        if (input.periodicityCheck)
+            escapeTimeBatch<V, N, true>(input, iterations, periodic);
+        else
+            escapeTimeBatch<V, N, false>(input, iterations, periodic);
+    }
+}
+
+template<class V>
+void escapeTimeSIMD (SIMDInput<typename V::Real> const& input, unsigned int* iterations, bool* periodic)
+{
+    switch (input.bailoutInterval) {
+        case 4:
+            escapeTimeSIMD<V, 4>(input, iterations, periodic);
+        break;
+        case 8:
+            escapeTimeSIMD<V, 8>(input, iterations, periodic);
+        break;
+        case 16:
+            escapeTimeSIMD<V, 16>(input, iterations, periodic);
+        break;
+        default:
+            escapeTimeSIMD<V, 1>(input, iterations, periodic);
+        break;
+    }
+}
+
+}
+
+#endif // ESCAPETIMESIMDIMPL_HPP_INCLUDED
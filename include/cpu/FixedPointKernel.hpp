@@ -0,0 +1,35 @@
+#ifndef FIXEDPOINTKERNEL_HPP_INCLUDED
+#define FIXEDPOINTKERNEL_HPP_INCLUDED
+
+#include "cpu/EscapeTimeKernel.hpp"
+
+
+/* Kernel in 128-bit fixed point: a sign, 7 integer bits and 120 fraction bits, so numbers are 2^-120
+ * (about 7.5e-37) apart whatever their magnitude, and it resolves views until a zoom of about 1e32.
+ * All operations are on integers: products truncate the same way on every machine, and the counts
+ * are bit-identical wherever they are computed, so that tiles rendered by different machines can be
+ * cached and compared. Only the distance estimates and the final test of the cycle detection use doubles,
+ * whose basic operations are rounded the same way everywhere too.
+ * One pixel at a time: products are built from 64x64 -> 128-bit multiplies (mul, or mulx with BMI2),
+ * which vector units don't have.
+ * Coordinates and seeds beyond 64 are clamped to it: they escape at the same iteration anyway.
+ */
+class FixedPointKernel : public EscapeTimeKernel
+{
+    public:
+        virtual char const* getName() const;
+
+        virtual void compute (RenderParameters const& parameters, PixelMapping const& mapping,
+                              Pixel const* pixels, std::size_t count,
+                              IterationBuffer& buffer, RenderStats& stats) const;
+
+        virtual void computeDistances (RenderParameters const& parameters, PixelMapping const& mapping,
+                                       Pixel const* pixels, std::size_t count,
+                                       IterationBuffer& buffer, DistanceEstimate* estimates,
+                                       RenderStats& stats) const;
+
+        virtual void resume (RenderParameters const& parameters, PixelMapping const& mapping,
+                             Orbit* orbits, std::size_t count, RenderStats& stats) const;
+};
+
+#endif // FIXEDPOINTKERNEL_HPP_INCLUDED
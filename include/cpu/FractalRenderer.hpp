@@ -0,0 +1,56 @@
+#ifndef FRACTALRENDERER_HPP_INCLUDED
+#define FRACTALRENDERER_HPP_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include "cpu/IterationBuffer.hpp"
+#include "cpu/OrbitCache.hpp"
+#include "cpu/Palette.hpp"
+#include "cpu/RenderParameters.hpp"
+#include "cpu/RenderStats.hpp"
+#include "cpu/Tile.hpp"
+
+
+/* Renders a fractal to memory, without any window nor OpenGL context.
+ * The size of the buffer passed to render() defines the resolution.
+ */
+class FractalRenderer
+{
+    public:
+        virtual ~FractalRenderer() {}
+
+        /* Fills buffer with iteration counts, and updates the statistics */
+        void render (RenderParameters const& parameters, IterationBuffer& buffer);
+
+        /* Same as render(), but only fills the given areas of the buffer, which don't overlap:
+         * the other pixels are kept. The statistics only count the pixels of the areas.
+         */
+        void render (RenderParameters const& parameters, std::vector<Tile> const& areas, IterationBuffer& buffer);
+
+        /* Brings the frame the cache holds to parameters.maxIter, and writes it to buffer:
+         * only the orbits that didn't escape are iterated, and only if maxIter rose.
+         * The statistics count the whole frame, and the orbits iterated as computed.
+         */
+        void resume (RenderParameters const& parameters, OrbitCache& cache, IterationBuffer& buffer);
+
+        /* Same as render(), then maps the iteration counts through the palette */
+        void render (RenderParameters const& parameters, Palette const& palette,
+                     IterationBuffer& buffer, std::vector<std::uint8_t>& rgba);
+
+        /* Statistics of the last render */
+        RenderStats const& getStats() const;
+
+    protected:
+        virtual void doRender (RenderParameters const& parameters, std::vector<Tile> const& areas,
+                               IterationBuffer& buffer, RenderStats& stats) = 0;
+
+        /* Resumes the count orbits, see EscapeTimeKernel::resume() */
+        virtual void doResume (RenderParameters const& parameters, PixelMapping const& mapping,
+                               Orbit* orbits, std::size_t count, RenderStats& stats) = 0;
+
+    private:
+        RenderStats _stats;
+};
+
+#endif // FRACTALRENDERER_HPP_INCLUDED
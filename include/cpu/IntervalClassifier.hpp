@@ -0,0 +1,20 @@
+#ifndef INTERVALCLASSIFIER_HPP_INCLUDED
+#define INTERVALCLASSIFIER_HPP_INCLUDED
+
+#include "cpu/RenderParameters.hpp"
+#include "cpu/Tile.hpp"
+
+
+/* Iterates all the pixels of the rectangle at once, as a box of complex numbers in interval arithmetic.
+ * Returns true if the whole rectangle is proven to get a single iteration count, which is then stored:
+ * - either every pixel escapes at the same iteration;
+ * - or the box comes back inside one of its previous states without ever crossing |z| = 2,
+ *   so that no pixel can escape (or maxIter is reached first).
+ * The intervals are widened after each operation by more than a float rounding error,
+ * so what is proven holds for the float and double kernels, not only for exact arithmetic:
+ * a classified rectangle gets the same counts as a brute-force render.
+ */
+bool classifyRectangle (RenderParameters const& parameters, PixelMapping const& mapping,
+                        Tile const& rectangle, unsigned int& iterations);
+
+#endif // INTERVALCLASSIFIER_HPP_INCLUDED
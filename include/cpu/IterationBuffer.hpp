@@ -0,0 +1,38 @@
+#ifndef ITERATIONBUFFER_HPP_INCLUDED
+#define ITERATIONBUFFER_HPP_INCLUDED
+
+#include <vector>
+
+
+/* Per-pixel iteration counts of a CPU render, row 0 being the bottom row.
+ * A pixel that never escaped holds the maxIter it was rendered with.
+ */
+class IterationBuffer
+{
+    public:
+        IterationBuffer (unsigned int width=0, unsigned int height=0);
+
+        void resize (unsigned int width, unsigned int height);
+
+        unsigned int getWidth() const;
+        unsigned int getHeight() const;
+
+        unsigned int& at (unsigned int x, unsigned int y)
+        {
+            return _iterations[y * _width + x];
+        }
+        unsigned int at (unsigned int x, unsigned int y) const
+        {
+            return _iterations[y * _width + x];
+        }
+
+        std::vector<unsigned int> const& getData() const;
+
+    private:
+        unsigned int _width;
+        unsigned int _height;
+
+        std::vector<unsigned int> _iterations;
+};
+
+#endif // ITERATIONBUFFER_HPP_INCLUDED
@@ -0,0 +1,17 @@
+#ifndef MARIANISILVER_HPP_INCLUDED
+#define MARIANISILVER_HPP_INCLUDED
+
+#include "cpu/Tile.hpp"
+#include "cpu/TileContext.hpp"
+
+
+/* Mariani-Silver subdivision. The Mandelbrot set and the iteration bands around it are connected,
+ * so a rectangle whose border has a single iteration count holds that count inside too.
+ * Only the border of the tile is computed; rectangles with a uniform border are filled,
+ * the others are split in two by computing their median line, and so on.
+ * Features thinner than a pixel can slip between two border samples, so the result
+ * may differ from a brute-force render on a few pixels.
+ */
+void renderMarianiSilver (TileContext const& context, Tile const& tile);
+
+#endif // MARIANISILVER_HPP_INCLUDED
@@ -0,0 +1,52 @@
+#ifndef ORBITCACHE_HPP_INCLUDED
+#define ORBITCACHE_HPP_INCLUDED
+
+#include <vector>
+
+#include "cpu/EscapeTimeKernel.hpp"
+#include "cpu/IterationBuffer.hpp"
+#include "cpu/RenderParameters.hpp"
+
+
+/* Keeps a frame whatever its maxIter, see FractalRenderer::resume().
+ * Counts are kept unclamped: a pixel that escaped keeps its escape iteration, so lowering maxIter
+ * only clamps the counts again. Only the pixels that didn't escape keep an orbit, which raising
+ * maxIter iterates further from where it stopped.
+ */
+class OrbitCache
+{
+    public:
+        OrbitCache();
+
+        /* Takes over buffer, a frame rendered with parameters. Renders don't keep z:
+         * the orbits of its pixels at maxIter start over the first time they are resumed.
+         */
+        void reset (RenderParameters const& parameters, IterationBuffer const& buffer);
+
+        void clear();
+
+        /* True if the frame is the view of parameters, maxIter apart */
+        bool holds (RenderParameters const& parameters) const;
+
+        RenderParameters const& getParameters() const;
+        unsigned int getWidth() const;
+        unsigned int getHeight() const;
+
+        /* Orbits that didn't reach maxIter come first, then their number is returned */
+        std::size_t prepare (unsigned int maxIter);
+        Orbit* getOrbits();
+
+        /* Once the prepared orbits were resumed up to maxIter, keeps the new counts,
+         * forgets the orbits that escaped or were found interior, and writes the frame to buffer
+         */
+        void update (unsigned int maxIter, IterationBuffer& buffer);
+
+    private:
+        RenderParameters _parameters;
+        bool _valid;
+
+        IterationBuffer _counts; //unclamped, escape iteration or iterations run so far, see interiorCount
+        std::vector<Orbit> _orbits; //of the pixels that may still escape
+};
+
+#endif // ORBITCACHE_HPP_INCLUDED
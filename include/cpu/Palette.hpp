@@ -0,0 +1,39 @@
+#ifndef PALETTE_HPP_INCLUDED
+#define PALETTE_HPP_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include "cpu/IterationBuffer.hpp"
+
+
+/* CPU counterpart of the palette texture sampled by the fragment shaders.
+ * Lookups are linearly interpolated and clamped to the edges,
+ * like the smoothed sf::Texture used by Fractal.
+ */
+class Palette
+{
+    public:
+        /* rgba holds one row of 4-bytes pixels */
+        Palette (std::uint8_t const* rgba, unsigned int width);
+
+        /* Black to white gradient */
+        static Palette grayscale();
+
+        unsigned int getWidth() const;
+
+        /* r in [0,1], writes 4 bytes */
+        void sample (float r, std::uint8_t* rgba) const;
+
+        /* Maps iteration counts to colors like the shaders do: palette(iter / maxIter), shifted by offset
+         * in [0,1[ and wrapped around for the pixels below maxIter, see coloring.frag.
+         * rgba is resized to 4 bytes per pixel.
+         */
+        void colorize (IterationBuffer const& buffer, unsigned int maxIter, std::vector<std::uint8_t>& rgba,
+                       float offset = 0.f) const;
+
+    private:
+        std::vector<std::uint8_t> _colors;
+};
+
+#endif // PALETTE_HPP_INCLUDED
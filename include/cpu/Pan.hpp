@@ -0,0 +1,33 @@
+#ifndef PAN_HPP_INCLUDED
+#define PAN_HPP_INCLUDED
+
+#include <vector>
+
+#include "cpu/IterationBuffer.hpp"
+#include "cpu/RenderParameters.hpp"
+#include "cpu/Tile.hpp"
+
+
+/* Translation by a whole number of pixels between two views of the same fractal:
+ * pixel (x,y) of the new view is pixel (x + offsetX, y + offsetY) of the previous one.
+ */
+struct Pan
+{
+    int offsetX;
+    int offsetY;
+};
+
+/* Returns true if current only differs from previous by a pan of less than the view size
+ * from the same anchor, see Camera::relativeMovement.
+ * The pixels both views share then have the same world positions to the bit, so the same counts.
+ * Views of different anchors are not panned, even by what looks like whole pixels: they are rendered again.
+ */
+bool findPan (RenderParameters const& previous, RenderParameters const& current,
+              unsigned int width, unsigned int height, Pan& pan);
+
+/* Moves the pixels of buffer by the pan, and returns the areas it exposed,
+ * which hold stale counts and have to be rendered again
+ */
+std::vector<Tile> applyPan (Pan const& pan, IterationBuffer& buffer);
+
+#endif // PAN_HPP_INCLUDED
@@ -0,0 +1,60 @@
+#ifndef PRECISIONLADDER_HPP_INCLUDED
+#define PRECISIONLADDER_HPP_INCLUDED
+
+#include <vector>
+
+#include "cpu/RenderParameters.hpp"
+
+
+/* Number formats of the kernels and shaders, from the cheapest to the most precise.
+ * DoubleFloat is the unevaluated sum of two floats, for the GPUs without doubles, and DoubleDouble that of two doubles.
+ * Fixed128 is a 128-bit integer with 120 fraction bits, whose ulp doesn't depend on the magnitude.
+ */
+enum class Precision{Float, DoubleFloat, Double, DoubleDouble, Fixed128};
+
+char const* getPrecisionName (Precision precision);
+
+/* Spacing of the numbers of the format between 1 and 2: the ulp of x is about x times this,
+ * or this whatever x for Fixed128
+ */
+double getPrecisionEpsilon (Precision precision);
+
+/* Distance between two adjacent pixels of the view, in ulps of the format at the largest
+ * coordinate of the view: below a few ulps, rounding merges neighbouring pixels into blocks
+ */
+double getPixelUlps (Precision precision, RenderParameters const& parameters, unsigned int width, unsigned int height);
+
+/* A format resolves a view when its pixels are at least this many ulps apart */
+const double minPixelUlps = 4.0;
+
+
+/* Formats of increasing precision a renderer has kernels or shaders for, and the choice of the cheapest
+ * one that resolves the view: each tier is several times slower than the previous one.
+ */
+class PrecisionLadder
+{
+    public:
+        PrecisionLadder();
+
+        /* Formats are added from the cheapest to the most precise */
+        void add (Precision precision);
+
+        /* Picks the cheapest format that resolves the view, or the most precise one if none does,
+         * and returns true if it is not the one picked last time.
+         * A view that hovers around a threshold would make the tiers alternate: the tier in use is
+         * only left for a cheaper one once that one resolves the view with twice the margin.
+         */
+        bool select (RenderParameters const& parameters, unsigned int width, unsigned int height);
+
+        Precision getPrecision() const;
+
+        /* False if even the most precise format doesn't resolve the last view selected */
+        bool resolvesView() const;
+
+    private:
+        std::vector<Precision> _tiers;
+        std::size_t _current; //index in _tiers
+        bool _resolvesView;
+};
+
+#endif // PRECISIONLADDER_HPP_INCLUDED
@@ -0,0 +1,116 @@
+#ifndef RENDERPARAMETERS_HPP_INCLUDED
+#define RENDERPARAMETERS_HPP_INCLUDED
+
+#include "glm.hpp"
+
+#include "FractalType.hpp"
+
+
+/* Default tolerance of the periodicity checking, as a fraction of the pixel size */
+const double defaultPeriodicityTolerance = 1e-3;
+
+
+/* Inputs of a CPU render: the same values Fractal feeds to its shaders */
+struct RenderParameters
+{
+    RenderParameters();
+
+    FractalType type;
+    glm::dvec2 seed; //only used by Julia
+    unsigned int maxIter;
+
+    /* Maps window coordinates ([-1,1]x[-1,1]) to world coordinates, see Camera */
+    glm::dmat3 invViewMatrix;
+
+    /* The view is its anchor moved by panPixels whole pixels, and is centered on invViewMatrix[2].
+     * Pixel positions are computed from the anchor, see PixelMapping: two views panned from the same anchor
+     * give the pixels they share the same positions, to the bit. Set along with invViewMatrix, see Camera.
+     */
+    glm::dvec2 anchor;
+    glm::ivec2 panPixels;
+
+    /* Mandelbrot only: pixels in the main cardioid or the period-2 bulb are known to be
+     * interior, and get maxIter without iterating
+     */
+    bool cardioidCheck;
+
+    /* Brent cycle detection: an orbit that comes back twice within periodicityTolerance pixel
+     * of one of its previous points is considered periodic, so interior, and gets maxIter, see CycleDetector
+     */
+    bool periodicityCheck;
+    double periodicityTolerance;
+
+    /* Tiles are first iterated as a whole in interval arithmetic, and filled without
+     * per-pixel work when proven to get a single count, see IntervalClassifier
+     */
+    bool intervalCheck;
+
+    /* When the view contains the mirror image of some of its pixels (about the real axis for Mandelbrot,
+     * about the origin for Julia), these are copied instead of rendered, see Symmetry
+     */
+    bool symmetryCheck;
+
+    /* Progressive rendering: a pass of step above 1 only computes the pixels whose coordinates are
+     * both multiples of step, and copies each of them to the step x step block it is the bottom-left corner of.
+     * Passes of decreasing steps then refine the same buffer: the pixels of the knownStep grid were
+     * computed by the previous pass and are kept, knownStep being a multiple of step (0 if none).
+     */
+    unsigned int step;
+    unsigned int knownStep;
+
+    /* True if pixel (x,y) was computed by a previous pass */
+    bool isKnown (unsigned int x, unsigned int y) const
+    {
+        return knownStep != 0 && x % knownStep == 0 && y % knownStep == 0;
+    }
+};
+
+/* True if a and b give every point of the plane the same count, whatever their views */
+bool isSameFractal (RenderParameters const& a, RenderParameters const& b);
+
+/* True if a and b map pixels to the same world positions */
+bool isSameView (RenderParameters const& a, RenderParameters const& b);
+
+
+/* Maps buffer pixels to world coordinates.
+ * Pixel (x,y) is sampled at its center, like a fragment, and row 0 is the bottom row.
+ * Positions are the anchor of the view plus an offset computed from the pixel distance to the middle
+ * of the buffer moved by the pan: pixels mirrored about the middle of an unpanned view get offsets
+ * that are exact negations of each other, and a pan keeps the offsets of the pixels it moves.
+ */
+class PixelMapping
+{
+    public:
+        PixelMapping (RenderParameters const& parameters, unsigned int width, unsigned int height);
+
+        glm::dvec2 toWorld (double x, double y) const
+        {
+            return _center + toCenterOffset(x, y);
+        }
+
+        /* Anchor of the view, and world offset of pixel (x,y) to it: their sum is toWorld(x,y),
+         * but kept apart they locate pixels below the resolution of doubles around the anchor
+         */
+        glm::dvec2 const& getCenter() const;
+
+        glm::dvec2 toCenterOffset (double x, double y) const
+        {
+            /* Both differences are exact */
+            return (x - _middle.x) * _stepX + (y - _middle.y) * _stepY;
+        }
+
+        /* World offsets between two horizontally (resp. vertically) adjacent pixels */
+        glm::dvec2 const& getStepX() const;
+        glm::dvec2 const& getStepY() const;
+
+        /* Smallest distance between two adjacent pixels */
+        double getPixelSize() const;
+
+    private:
+        glm::dvec2 _center;
+        glm::dvec2 _middle; //pixel coordinates of the anchor, whole or half
+        glm::dvec2 _stepX;
+        glm::dvec2 _stepY;
+};
+
+#endif // RENDERPARAMETERS_HPP_INCLUDED
@@ -0,0 +1,32 @@
+#ifndef RENDERSTATS_HPP_INCLUDED
+#define RENDERSTATS_HPP_INCLUDED
+
+#include <cstdint>
+
+
+/* Counters filled by a CPU render. Kernels accumulate into their own instance,
+ * which the renderer then merges.
+ */
+struct RenderStats
+{
+    RenderStats();
+
+    void merge (RenderStats const& other);
+
+    double getMegaPixelsPerSecond() const;
+
+    /* Share of the frame that was actually computed, between 0 and 1 */
+    double getComputedFraction() const;
+
+    std::uint64_t pixels; //pixels in the frame, or in the areas rendered, see FractalRenderer::render()
+    std::uint64_t computedPixels; //pixels handed to the kernel, the others were deduced from their neighbours
+    std::uint64_t classifiedPixels; //pixels of the rectangles proven uniform by interval arithmetic
+    std::uint64_t culledPixels; //pixels filled from the distance estimate of a nearby sample
+    std::uint64_t mirroredPixels; //pixels copied from their mirror image
+    std::uint64_t iterations; //escape-time iterations actually run
+    std::uint64_t cardioidSkipped; //pixels found in the main cardioid or period-2 bulb
+    std::uint64_t periodicExits; //pixels whose orbit was found periodic before maxIter
+    double seconds; //wall-clock duration of the frame
+};
+
+#endif // RENDERSTATS_HPP_INCLUDED
@@ -0,0 +1,30 @@
+#ifndef REPROJECTION_HPP_INCLUDED
+#define REPROJECTION_HPP_INCLUDED
+
+#include <vector>
+
+#include "cpu/IterationBuffer.hpp"
+#include "cpu/RenderParameters.hpp"
+#include "cpu/Tile.hpp"
+
+
+/* Preview of a view resampled from another view of the same fractal, see reproject() */
+struct Reprojection
+{
+    double coverage; //share of the pixels that fell inside of the previous view, between 0 and 1
+
+    /* Tiles covering the frame, by decreasing estimated error: the ones to render first */
+    std::vector<Tile> tiles;
+};
+
+/* Fills destination, a view of current, with the counts of the nearest pixels of source,
+ * a view of previous, without iterating. Pixels that fall outside of source get the count
+ * of its nearest edge pixel.
+ * The error of a pixel is estimated by how much the counts vary around its source pixel,
+ * and is maximal outside of source: a tile's error is the sum of its pixels'.
+ */
+Reprojection reproject (RenderParameters const& previous, IterationBuffer const& source,
+                        RenderParameters const& current, IterationBuffer& destination,
+                        unsigned int tileSize);
+
+#endif // REPROJECTION_HPP_INCLUDED
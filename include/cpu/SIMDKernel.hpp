@@ -0,0 +1,70 @@
+#ifndef SIMDKERNEL_HPP_INCLUDED
+#define SIMDKERNEL_HPP_INCLUDED
+
+#include <string>
+
+#include "cpu/DoubleDouble.hpp"
+#include "cpu/EscapeTimeKernel.hpp"
+
+
+/* Instruction sets of the vectorized kernels, from the narrowest to the widest */
+enum class SIMDLevel{SSE2, AVX2, AVX512};
+
+/* Widest instruction set supported by the running CPU (and OS) */
+SIMDLevel getBestSIMDLevel();
+
+char const* getSIMDLevelName (SIMDLevel level);
+
+
+/* How pixels are scheduled over the vector lanes:
+ * - Batch: a batch of pixels is loaded, then iterated until all of its lanes are done
+ * - Refill: a lane is reloaded with the next pending pixel as soon as its pixel is done,
+ *   which keeps the lanes busy when escape times are very different (set boundary, high maxIter)
+ */
+enum class LaneMode{Batch, Refill};
+
+
+/* Iterates 4 to 16 pixels at once, one per vector lane, each lane with its own escape mask.
+ * Produces the same iteration counts as ScalarKernel<T>.
+ * Double-double lanes are pairs of double vectors, with as many lanes as doubles.
+ */
+template<typename T>
+class SIMDKernel : public EscapeTimeKernel
+{
+    public:
+        /* Uses the best instruction set available.
+         * bailoutInterval: 1 to test for escape at each iteration, or 4, 8 or 16 to test once
+         * per block of iterations, with a rollback when a lane escaped inside the block.
+         */
+        explicit SIMDKernel (LaneMode laneMode=LaneMode::Batch, unsigned int bailoutInterval=1);
+
+        /* Throws if the CPU doesn't support level */
+        explicit SIMDKernel (SIMDLevel level, LaneMode laneMode=LaneMode::Batch, unsigned int bailoutInterval=1);
+
+        SIMDLevel getLevel() const;
+        LaneMode getLaneMode() const;
+        unsigned int getBailoutInterval() const;
+
+        virtual char const* getName() const;
+
+        virtual void compute (RenderParameters const& parameters, PixelMapping const& mapping,
+                              Pixel const* pixels, std::size_t count,
+                              IterationBuffer& buffer, RenderStats& stats) const;
+
+        /* Not vectorized: see computeDistanceEstimates() */
+        virtual void computeDistances (RenderParameters const& parameters, PixelMapping const& mapping,
+                                       Pixel const* pixels, std::size_t count,
+                                       IterationBuffer& buffer, DistanceEstimate* estimates,
+                                       RenderStats& stats) const;
+
+        virtual void resume (RenderParameters const& parameters, PixelMapping const& mapping,
+                             Orbit* orbits, std::size_t count, RenderStats& stats) const;
+
+    private:
+        SIMDLevel _level;
+        LaneMode _laneMode;
+        unsigned int _bailoutInterval;
+        std::string _name;
+};
+
+#endif // SIMDKERNEL_HPP_INCLUDED
@@ -0,0 +1,306 @@
+#ifndef SCALARKERNEL_HPP_INCLUDED
+#define SCALARKERNEL_HPP_INCLUDED
+
+#include <string>
+
+#include "cpu/Bailout.hpp"
+#include "cpu/DoubleDouble.hpp"
+#include "cpu/EscapeTimeKernel.hpp"
+
+
+/* Reference kernel: one pixel at a time, in float, double or double-double precision */
+template<typename T>
+class ScalarKernel : public EscapeTimeKernel
+{
+    public:
+        /* bailoutInterval: see escapeTimeDeferred(), throws if not supported */
+        explicit ScalarKernel (unsigned int bailoutInterval=1);
+
+        unsigned int getBailoutInterval() const;
+
+        virtual char const* getName() const;
+
+        virtual void compute (RenderParameters const& parameters, PixelMapping const& mapping,
+                              Pixel const* pixels, std::size_t count,
+                              IterationBuffer& buffer, RenderStats& stats) const;
+
+        virtual void computeDistances (RenderParameters const& parameters, PixelMapping const& mapping,
+                                       Pixel const* pixels, std::size_t count,
+                                       IterationBuffer& buffer, DistanceEstimate* estimates,
+                                       RenderStats& stats) const;
+
+        virtual void resume (RenderParameters const& parameters, PixelMapping const& mapping,
+                             Orbit* orbits, std::size_t count, RenderStats& stats) const;
+
+    private:
+        unsigned int _bailoutInterval;
+        std::string _name;
+};
+
+
+/* Name of the format of the kernels */
+template<typename T>
+inline char const* getRealName();
+
+template<>
+inline char const* getRealName<float>()
+{
+    return "float";
+}
+
+template<>
+inline char const* getRealName<double>()
+{
+    return "double";
+}
+
+template<>
+inline char const* getRealName<DoubleDouble>()
+{
+    return "double-double";
+}
+
+/* Position of pixel (x,y) in the format of the kernels */
+template<typename T>
+inline void toKernelPosition (PixelMapping const& mapping, unsigned int x, unsigned int y, T& posX, T& posY)
+{
+    glm::dvec2 pos = mapping.toWorld(x, y);
+    posX = static_cast<T>(pos.x);
+    posY = static_cast<T>(pos.y);
+}
+
+/* The center of the view plus the offset of the pixel to it, summed without rounding:
+ * pixels stay apart far below the resolution of doubles, as long as the center is a double
+ */
+template<>
+inline void toKernelPosition<DoubleDouble> (PixelMapping const& mapping, unsigned int x, unsigned int y,
+                                            DoubleDouble& posX, DoubleDouble& posY)
+{
+    glm::dvec2 const& center = mapping.getCenter();
+    glm::dvec2 offset = mapping.toCenterOffset(x, y);
+    posX = twoSum(center.x, offset.x);
+    posY = twoSum(center.y, offset.y);
+}
+
+/* z of an orbit, see Orbit */
+template<typename T>
+inline void loadOrbit (Orbit const& orbit, T& zx, T& zy)
+{
+    zx = static_cast<T>(orbit.zx);
+    zy = static_cast<T>(orbit.zy);
+}
+
+template<>
+inline void loadOrbit<DoubleDouble> (Orbit const& orbit, DoubleDouble& zx, DoubleDouble& zy)
+{
+    zx = DoubleDouble{orbit.zx, orbit.zxLo};
+    zy = DoubleDouble{orbit.zy, orbit.zyLo};
+}
+
+template<typename T>
+inline void saveOrbit (T zx, T zy, Orbit& orbit)
+{
+    orbit.zx = zx;
+    orbit.zy = zy;
+    orbit.zxLo = orbit.zyLo = 0.0;
+}
+
+template<>
+inline void saveOrbit<DoubleDouble> (DoubleDouble zx, DoubleDouble zy, Orbit& orbit)
+{
+    orbit.zx = zx.hi;
+    orbit.zy = zy.hi;
+    orbit.zxLo = zx.lo;
+    orbit.zyLo = zy.lo;
+}
+
+
+/* Iterates z = z² + c from z until |z| > 2 or maxIter is reached, leaving z where the orbit stopped */
+template<typename T>
+inline unsigned int escapeTime (T& zx, T& zy, T cx, T cy, unsigned int maxIter)
+{
+    unsigned int iter = 0;
+    while (iter < maxIter) {
+        T x2 = zx * zx, y2 = zy * zy;
+        if (x2 + y2 > toReal<T>(4.0))
+            break;
+
+        zy = toReal<T>(2.0) * zx * zy + cy;
+        zx = x2 - y2 + cx;
+
+        ++iter;
+    }
+
+    return iter;
+}
+
+/* Brent's cycle detection: z is compared with a reference point of the orbit,
+ * which jumps to the current point after 1, 2, 4, 8... comparisons.
+ * A single return near the reference may be a chaotic orbit passing by, which then escapes:
+ * the orbit is only periodic once it came back near the same reference point twice.
+ */
+template<typename T>
+class CycleDetector
+{
+    public:
+        /* tolerance2: squared distance under which two points are considered equal */
+        CycleDetector (T zx, T zy, T tolerance2):
+                    _refX(zx),
+                    _refY(zy),
+                    _tolerance2(tolerance2),
+                    _steps(0),
+                    _period(1),
+                    _returned(false),
+                    _periodic(false)
+        {
+        }
+
+        /* True if z came back to the reference point for the second time */
+        bool check (T zx, T zy)
+        {
+            T dx = zx - _refX, dy = zy - _refY;
+            if (dx * dx + dy * dy <= _tolerance2) {
+                if (_returned) {
+                    _periodic = true;
+                    return true;
+                }
+                _returned = true;
+            }
+
+            if (++_steps == _period) {
+                _steps = 0;
+                _period *= 2;
+                _refX = zx;
+                _refY = zy;
+                _returned = false;
+            }
+            return false;
+        }
+
+        bool isPeriodic() const
+        {
+            return _periodic;
+        }
+
+    private:
+        T _refX, _refY;
+        T _tolerance2;
+        unsigned int _steps, _period;
+        bool _returned;
+        bool _periodic;
+};
+
+/* Same as escapeTime, but stops as soon as the detector finds the orbit periodic,
+ * in which case the point is interior and the caller should use maxIter instead
+ */
+template<typename T>
+inline unsigned int escapeTimePeriodic (T& zx, T& zy, T cx, T cy, unsigned int maxIter, CycleDetector<T>& detector)
+{
+    unsigned int iter = 0;
+    while (iter < maxIter) {
+        T x2 = zx * zx, y2 = zy * zy;
+        if (x2 + y2 > toReal<T>(4.0))
+            break;
+
+        zy = toReal<T>(2.0) * zx * zy + cy;
+        zx = x2 - y2 + cx;
+
+        ++iter;
+
+        if (detector.check(zx, zy))
+            break;
+    }
+
+    return iter;
+}
+
+/* Same result as escapeTime, but when canDeferBailout(c) the escape is only tested
+ * after each block of N iterations. If z escaped during a block, the block is replayed
+ * from its start with escapeTime to find the exact iteration.
+ * There is no cycle detection: checked at block ends only, cycles would be found later
+ * than by escapeTimePeriodic, and the iteration counts would differ.
+ */
+template<typename T, unsigned int N>
+inline unsigned int escapeTimeDeferred (T& zx, T& zy, T cx, T cy, unsigned int maxIter)
+{
+    if (!canDeferBailout(cx, cy))
+        return escapeTime<T>(zx, zy, cx, cy, maxIter);
+
+    unsigned int iter = 0;
+    T x2 = zx * zx, y2 = zy * zy;
+    while (maxIter - iter >= N) {
+        const T savedX = zx, savedY = zy;
+
+        for (unsigned int i = 0; i < N; ++i) {
+            zy = toReal<T>(2.0) * zx * zy + cy;
+            zx = x2 - y2 + cx;
+            x2 = zx * zx;
+            y2 = zy * zy;
+        }
+
+        /* Also true for infinities and NaNs */
+        if (!(x2 + y2 <= toReal<T>(4.0))) {
+            zx = savedX;
+            zy = savedY;
+            return iter + escapeTime<T>(zx, zy, cx, cy, N);
+        }
+
+        iter += N;
+    }
+
+    return iter + escapeTime<T>(zx, zy, cx, cy, maxIter - iter);
+}
+
+/* Fills estimate from the first point of the orbit out of the |z| = 2 circle, its iteration
+ * and the derivative dz there. The orbit is followed a bit further, so that the Green function G
+ * and its gradient are accurately known, and the distance to the set is bounded from below by
+ * sinh(G) / (2 e^G |grad G|), a consequence of the Koebe 1/4 theorem.
+ * For Julia, the bound only holds if the Julia set is connected.
+ */
+void estimateDistance (double zx, double zy, double cx, double cy, double dzx, double dzy,
+                       unsigned int iter, bool julia, DistanceEstimate& estimate);
+
+/* Same count as escapeTime (or escapeTimePeriodic with a detector), also computing
+ * the derivative of z with respect to c (Mandelbrot) or to the starting point (Julia).
+ * The derivative is carried in double: it grows much faster than z, and only needs the few leading digits of z.
+ */
+template<typename T>
+inline unsigned int escapeTimeDistance (T zx, T zy, T cx, T cy, unsigned int maxIter, bool julia,
+                                        DistanceEstimate& estimate, CycleDetector<T>* detector=nullptr)
+{
+    const double dc = julia ? 0.0 : 1.0;
+    double dzx = 1.0, dzy = 0.0;
+
+    unsigned int iter = 0;
+    while (iter < maxIter) {
+        T x2 = zx * zx, y2 = zy * zy;
+        if (x2 + y2 > toReal<T>(4.0)) {
+            estimateDistance(toDouble(zx), toDouble(zy), toDouble(cx), toDouble(cy), dzx, dzy, iter, julia, estimate);
+            return iter;
+        }
+
+        const double x = toDouble(zx), y = toDouble(zy);
+        const double newDzx = 2.0 * (x * dzx - y * dzy) + dc;
+        dzy = 2.0 * (x * dzy + y * dzx);
+        dzx = newDzx;
+
+        zy = toReal<T>(2.0) * zx * zy + cy;
+        zx = x2 - y2 + cx;
+
+        ++iter;
+
+        if (detector && detector->check(zx, zy))
+            break;
+    }
+
+    estimate = DistanceEstimate();
+    return iter;
+}
+
+/* computeDistances() of the scalar and vectorized kernels, which both rely on escapeTimeDistance */
+template<typename T>
+void computeDistanceEstimates (RenderParameters const& parameters, PixelMapping const& mapping,
+                               Pixel const* pixels, std::size_t count,
+                               IterationBuffer& buffer, DistanceEstimate* estimates, RenderStats& stats);
+
+#endif // SCALARKERNEL_HPP_INCLUDED
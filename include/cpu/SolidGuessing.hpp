@@ -0,0 +1,16 @@
+#ifndef SOLIDGUESSING_HPP_INCLUDED
+#define SOLIDGUESSING_HPP_INCLUDED
+
+#include "cpu/Tile.hpp"
+#include "cpu/TileContext.hpp"
+
+
+/* Solid guessing, as in Fractint. Every 4th pixel of the tile is computed first:
+ * a 4x4 block whose corners agree is filled with their count. The other blocks get
+ * every 2nd pixel computed, and the 2x2 blocks whose corners disagree are computed entirely.
+ * Cheaper than boundary tracing but less careful: a detail that fits between the
+ * corners of a block is lost.
+ */
+void renderSolidGuessing (TileContext const& context, Tile const& tile);
+
+#endif // SOLIDGUESSING_HPP_INCLUDED
@@ -0,0 +1,34 @@
+#ifndef SYMMETRY_HPP_INCLUDED
+#define SYMMETRY_HPP_INCLUDED
+
+#include "cpu/IterationBuffer.hpp"
+#include "cpu/RenderParameters.hpp"
+#include "cpu/Tile.hpp"
+
+
+/* Part of a view that is the mirror image of another part of the same view.
+ * The Mandelbrot set is symmetric about the real axis: pixel (x,y) mirrors (x, offsetY - y).
+ * Julia sets are symmetric about the origin: pixel (x,y) mirrors (offsetX - x, offsetY - y).
+ */
+struct Symmetry
+{
+    bool flipX;
+    int offsetX;
+    int offsetY;
+
+    /* Pixels that are copied from their mirror, which lies outside of it */
+    Tile mirrored;
+};
+
+/* Returns true if some pixels of the width x height view mirror other pixels of it.
+ * Only unpanned views anchored on the real axis (Mandelbrot) or the origin (Julia) qualify: the world positions
+ * of their mirrored pixels are then exact mirror images, see PixelMapping, and the copied counts
+ * are those a render would give.
+ */
+bool findSymmetry (RenderParameters const& parameters, PixelMapping const& mapping,
+                   unsigned int width, unsigned int height, Symmetry& symmetry);
+
+/* Fills symmetry.mirrored from the pixels it mirrors, which must have been rendered */
+void copyMirrored (Symmetry const& symmetry, IterationBuffer& buffer);
+
+#endif // SYMMETRY_HPP_INCLUDED
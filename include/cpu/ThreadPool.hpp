@@ -0,0 +1,72 @@
+#ifndef THREADPOOL_HPP_INCLUDED
+#define THREADPOOL_HPP_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/* Persistent pool of workers with one task deque each.
+ * A worker pops tasks from the back of its own deque, and when it is empty
+ * steals from the front of the others', so that expensive tasks don't leave
+ * cores idle. The thread calling run() takes part as worker 0.
+ */
+class ThreadPool
+{
+    public:
+        typedef std::function<void(std::size_t task, unsigned int worker)> Task;
+
+    public:
+        /* 0 means one worker per hardware thread */
+        explicit ThreadPool (unsigned int workerCount=0);
+        ~ThreadPool();
+
+        ThreadPool (ThreadPool const&) = delete;
+        ThreadPool& operator= (ThreadPool const&) = delete;
+
+        unsigned int getWorkerCount() const;
+
+        /* Runs task(i, worker) for every i in [0, taskCount) and returns when all are done.
+         * Tasks are dealt round-robin, so neighbouring tasks start on different workers.
+         * Tasks must not throw.
+         */
+        void run (std::size_t taskCount, Task const& task);
+
+        static unsigned int getHardwareThreadCount();
+
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<std::size_t> tasks;
+            char padding[64]; //keeps the queues of different workers on different cache lines
+        };
+
+        void workerLoop (unsigned int worker);
+        void processTasks (unsigned int worker);
+
+        bool popLocal (unsigned int worker, std::size_t& task);
+        bool steal (unsigned int thief, std::size_t& task);
+
+    private:
+        std::vector<std::unique_ptr<Queue>> _queues;
+        std::vector<std::thread> _threads;
+
+        Task const* _task;
+        std::atomic<std::size_t> _remainingTasks;
+
+        std::mutex _mutex;
+        std::condition_variable _wakeUp;
+        std::condition_variable _finished;
+        unsigned long _generation;
+        unsigned int _busyWorkers;
+        bool _stop;
+};
+
+#endif // THREADPOOL_HPP_INCLUDED
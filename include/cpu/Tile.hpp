@@ -0,0 +1,23 @@
+#ifndef TILE_HPP_INCLUDED
+#define TILE_HPP_INCLUDED
+
+#include <vector>
+
+
+/* Rectangle of pixels, the unit of work of the CPU renderers */
+struct Tile
+{
+    unsigned int x, y; //bottom-left pixel
+    unsigned int width, height;
+};
+
+/* Covers a width x height image with tiles of at most tileSize x tileSize pixels, row after row */
+std::vector<Tile> splitInTiles (unsigned int width, unsigned int height, unsigned int tileSize);
+
+/* Same, for the pixels outside of hole, which lies within the image */
+std::vector<Tile> splitInTiles (unsigned int width, unsigned int height, Tile const& hole, unsigned int tileSize);
+
+/* Covers each of the areas with tiles of at most tileSize x tileSize pixels */
+std::vector<Tile> splitInTiles (std::vector<Tile> const& areas, unsigned int tileSize);
+
+#endif // TILE_HPP_INCLUDED
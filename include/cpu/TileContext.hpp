@@ -0,0 +1,36 @@
+#ifndef TILECONTEXT_HPP_INCLUDED
+#define TILECONTEXT_HPP_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include "cpu/EscapeTimeKernel.hpp"
+#include "cpu/IterationBuffer.hpp"
+#include "cpu/RenderParameters.hpp"
+#include "cpu/RenderStats.hpp"
+#include "cpu/Tile.hpp"
+
+
+/* What a render mode needs to fill one tile, as seen by one worker thread */
+struct TileContext
+{
+    EscapeTimeKernel const& kernel;
+    RenderParameters const& parameters;
+    PixelMapping const& mapping;
+    IterationBuffer& buffer;
+    RenderStats& stats; //of the worker
+    std::vector<Pixel>& pixels; //scratch list of the worker
+    std::vector<std::uint8_t>& flags; //scratch per-pixel flags of the worker, for the render modes that need them
+    std::vector<DistanceEstimate>& estimates; //scratch of the worker, for the render modes that need them
+    IterationBuffer* culled; //if not null, set to 1 at the pixels filled from an estimate, see CPURenderer::setCulledPixels
+
+    /* Runs the kernel on the pixels list, and counts them as computed.
+     * The pixels a previous pass computed are removed from the list first, see RenderParameters::knownStep.
+     */
+    void computePixels() const;
+
+    /* Computes every pixel of the rectangle */
+    void computeRectangle (Tile const& rectangle) const;
+};
+
+#endif // TILECONTEXT_HPP_INCLUDED
@@ -0,0 +1,32 @@
+#version 130
+
+
+/* Counts written by the iteration pass, row 0 at the bottom, see mandelbrot.frag */
+uniform sampler2D iterations;
+
+uniform sampler2D palette;
+
+uniform uint maxIter;
+
+/* Shift of the palette in [0,1[, applied to the points that escaped */
+uniform float paletteOffset;
+
+/* Colors the fractional part of the counts too, instead of showing bands */
+uniform bool smoothColoring;
+
+in vec2 fragPos;
+
+out vec4 fragColor;
+
+
+void main()
+{
+    float count = texture(iterations, fragPos).r;
+    if (!smoothColoring)
+        count = floor(count);
+
+    float r = count / float(maxIter);
+    if (count < float(maxIter))
+        r = fract(r + paletteOffset);
+    fragColor = texture(palette, vec2(r,0.5));
+}
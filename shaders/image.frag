@@ -0,0 +1,15 @@
+#version 130
+
+
+/* Image computed by the CPU engine, row 0 at the bottom */
+uniform sampler2D image;
+
+in vec2 fragPos;
+
+out vec4 fragColor;
+
+
+void main()
+{
+    fragColor = texture(image, fragPos);
+}
@@ -0,0 +1,119 @@
+#version 130
+
+
+/* julia.frag in double-float arithmetic, see mandelbrot_df64.frag */
+uniform uint maxIter;
+
+/* Orbits coming back that close to one of their previous points are considered periodic */
+uniform float periodicityTolerance;
+
+/* Origin of the view and seed in double-float, see mandelbrot_df64.frag */
+uniform vec2 originHi;
+uniform vec2 originLo;
+uniform vec2 cHi;
+uniform vec2 cLo;
+
+/* 0, see mandelbrot_df64.frag */
+uniform float zero;
+
+in vec2 fragPos;
+
+/* Iteration count, see the end of main() */
+out float fragIter;
+
+
+/* Error-free transforms: the rounding error of a float operation is a float.
+ * Compilers simplify (a + b) - a into b, which is the error they compute: zero is added to the sums
+ * they rely on, which compilers can't see is 0 (a product by a uniform 1 gets fused into the next sum).
+ */
+vec2 twoSum (const float a, const float b)
+{
+    float s = (a + b) + zero;
+    float v = (s - a) + zero;
+    return vec2(s, (a - (s - v)) + (b - v));
+}
+
+/* Same as twoSum(), when |a| >= |b| */
+vec2 quickTwoSum (const float a, const float b)
+{
+    float s = (a + b) + zero;
+    return vec2(s, b - (s - a));
+}
+
+/* Dekker's split of a float into two halves of 12 bits, whose products are exact */
+vec2 split (const float a)
+{
+    float t = 4097.0 * a;
+    float hi = t - ((t - a) + zero);
+    return vec2(hi, a - hi);
+}
+
+vec2 twoProduct (const float a, const float b)
+{
+    float p = a * b;
+    vec2 as = split(a), bs = split(b);
+    return vec2(p, ((as.x * bs.x - p) + as.x * bs.y + as.y * bs.x) + as.y * bs.y);
+}
+
+vec2 add (const vec2 a, const vec2 b)
+{
+    vec2 s = twoSum(a.x, b.x);
+    vec2 t = twoSum(a.y, b.y);
+    s = quickTwoSum(s.x, s.y + t.x);
+    return quickTwoSum(s.x, s.y + t.y);
+}
+
+vec2 multiply (const vec2 a, const vec2 b)
+{
+    vec2 p = twoProduct(a.x, b.x);
+    return quickTwoSum(p.x, p.y + (a.x * b.y + a.y * b.x));
+}
+
+void main()
+{
+    vec4 c = vec4(cHi.x, cLo.x, cHi.y, cLo.y);
+    vec4 z = vec4(add(vec2(originHi.x, originLo.x), vec2(fragPos.x, 0.0)),
+                  add(vec2(originHi.y, originLo.y), vec2(fragPos.y, 0.0)));
+    
+    /* Brent cycle detection: z is compared with a reference point of the orbit,
+     * which jumps to the current point after 1, 2, 4, 8... iterations.
+     * The orbit is periodic once it came back near the same reference point twice, see CycleDetector */
+    vec4 reference = z;
+    uint steps = 0u, period = 1u;
+    bool returned = false;
+    float tolerance2 = periodicityTolerance * periodicityTolerance;
+    
+    uint currIter = 0u;
+    while (currIter < maxIter) {
+        vec2 x2 = multiply(z.xy, z.xy);
+        vec2 y2 = multiply(z.zw, z.zw);
+        if (x2.x + y2.x > 4.0)
+            break;
+        
+        vec2 xy = multiply(z.xy, z.zw);
+        z = vec4(add(add(x2, -y2), c.xy), add(2.0 * xy, c.zw));
+        
+        ++currIter;
+        
+        vec2 d = vec2(add(z.xy, -reference.xy).x, add(z.zw, -reference.zw).x);
+        if (dot(d, d) <= tolerance2) {
+            if (returned) {
+                currIter = maxIter;
+                break;
+            }
+            returned = true;
+        }
+        if (++steps == period) {
+            steps = 0u;
+            period *= 2u;
+            reference = z;
+            returned = false;
+        }
+    }
+    
+    /* Same fraction as julia.frag: |z| is past the bailout, the high parts are enough */
+    float count = float(maxIter);
+    if (currIter < maxIter)
+        count = float(currIter) + 0.99 * clamp(1.0 - log2(log2(length(z.xz))), 0.0, 1.0);
+    fragIter = count;
+}
@@ -0,0 +1,70 @@
+#version 150
+#extension GL_ARB_gpu_shader_fp64 : require
+
+
+/* julia.frag in native doubles, see mandelbrot_fp64.frag */
+uniform uint maxIter;
+
+/* Orbits coming back that close to one of their previous points are considered periodic */
+uniform float periodicityTolerance;
+
+/* Origin of the view, see mandelbrot_fp64.frag */
+uniform dvec2 origin;
+
+uniform dvec2 c;
+
+in vec2 fragPos;
+
+/* Iteration count, see the end of main() */
+out float fragIter;
+
+
+dvec2 complexProduct (const dvec2 a, const dvec2 b)
+{
+    return dvec2(a.x * b.x - a.y * b.y,
+                 a.x * b.y + a.y * b.x);
+}
+
+void main()
+{
+    dvec2 z = origin + dvec2(fragPos);
+    
+    /* Brent cycle detection: z is compared with a reference point of the orbit,
+     * which jumps to the current point after 1, 2, 4, 8... iterations.
+     * The orbit is periodic once it came back near the same reference point twice, see CycleDetector */
+    dvec2 reference = z;
+    uint steps = 0u, period = 1u;
+    bool returned = false;
+    double tolerance2 = double(periodicityTolerance) * double(periodicityTolerance);
+    
+    uint currIter = 0u;
+    while (currIter < maxIter) {
+        if (dot(z, z) > 4.0LF)
+            break;
+        
+        z = complexProduct(z, z) + c;
+        
+        ++currIter;
+        
+        dvec2 d = z - reference;
+        if (dot(d, d) <= tolerance2) {
+            if (returned) {
+                currIter = maxIter;
+                break;
+            }
+            returned = true;
+        }
+        if (++steps == period) {
+            steps = 0u;
+            period *= 2u;
+            reference = z;
+            returned = false;
+        }
+    }
+    
+    /* Same fraction as julia.frag: |z| is past the bailout, floats are enough */
+    float count = float(maxIter);
+    if (currIter < maxIter)
+        count = float(currIter) + 0.99 * clamp(1.0 - log2(log2(length(vec2(z)))), 0.0, 1.0);
+    fragIter = count;
+}
@@ -0,0 +1,95 @@
+#version 130
+
+
+/* Orbits advanced by at most sliceIter iterations per draw, see Fractal::stepIterationsGPU().
+ * Each draw reads the state the previous one wrote and writes the next state (ping-pong):
+ * - gl_FragData[0] = (z.x, z.y, iterations run, status)
+ * - gl_FragData[1] = Brent cycle detection: (reference.x, reference.y, steps, period),
+ *   period being negated once the orbit came back near the reference point
+ * - gl_FragData[2] = iteration count for the coloring pass, like julia.frag
+ * gl_FragData orders the outputs, which GLSL 1.30 has no layout locations for.
+ */
+uniform sampler2D orbits;
+uniform sampler2D cycles;
+
+/* Starts the orbits over instead of reading them */
+uniform bool restart;
+
+uniform uint maxIter;
+uniform uint sliceIter;
+
+/* Orbits coming back that close to one of their previous points are considered periodic */
+uniform float periodicityTolerance;
+
+uniform vec2 c;
+
+in vec2 fragPos;
+
+
+const float running = 0.0;
+const float escaped = 1.0;
+const float interior = 2.0;
+
+vec2 complexProduct (const vec2 a, const vec2 b)
+{
+    return vec2(a.x * b.x - a.y * b.y,
+                a.x * b.y + a.y * b.x);
+}
+
+void main()
+{
+    vec4 orbit, cycle;
+    if (restart) {
+        orbit = vec4(fragPos, 0.0, running);
+        cycle = vec4(fragPos, 0.0, 1.0);
+    } else {
+        ivec2 texel = ivec2(gl_FragCoord.xy);
+        orbit = texelFetch(orbits, texel, 0);
+        cycle = texelFetch(cycles, texel, 0);
+    }
+
+    vec2 z = orbit.xy;
+    uint currIter = uint(orbit.z);
+    float status = orbit.w;
+    vec2 reference = cycle.xy;
+    uint steps = uint(cycle.z), period = uint(abs(cycle.w));
+    bool returned = (cycle.w < 0.0);
+    float tolerance2 = periodicityTolerance * periodicityTolerance;
+
+    /* Same loop as julia.frag, stopped at the end of the slice: an orbit that reaches maxIter stays running,
+     * so that a higher maxIter carries on with it */
+    uint sliceEnd = min(currIter + sliceIter, maxIter);
+    while (status == running && currIter < sliceEnd) {
+        if (length(z) > 2) {
+            status = escaped;
+            break;
+        }
+
+        z = complexProduct(z, z) + c;
+
+        ++currIter;
+
+        vec2 d = z - reference;
+        if (dot(d, d) <= tolerance2) {
+            if (returned) {
+                status = interior;
+                break;
+            }
+            returned = true;
+        }
+        if (++steps == period) {
+            steps = 0u;
+            period *= 2u;
+            reference = z;
+            returned = false;
+        }
+    }
+
+    float count = float(maxIter);
+    if (status == escaped && currIter < maxIter)
+        count = float(currIter) + 0.99 * clamp(1.0 - log2(log2(length(z))), 0.0, 1.0);
+
+    gl_FragData[0] = vec4(z, float(currIter), status);
+    gl_FragData[1] = vec4(reference, float(steps), returned ? -float(period) : float(period));
+    gl_FragData[2] = vec4(count, 0.0, 0.0, 1.0);
+}
@@ -1,13 +1,15 @@
 #version 130
 
 
-uniform sampler2D palette;
-
 uniform uint maxIter;
 
+/* Orbits coming back that close to one of their previous points are considered periodic */
+uniform float periodicityTolerance;
+
 in vec2 fragPos;
 
-out vec4 fragColor;
+/* Iteration count, see the end of main() */
+out float fragIter;
 
 
 vec2 complexProduct (const vec2 a, const vec2 b)
@@ -16,11 +18,36 @@ vec2 complexProduct (const vec2 a, const vec2 b)
                 a.x * b.y + a.y * b.x);
 }
 
+/* True if c lies in the main cardioid or in the period-2 bulb, where orbits never escape */
+bool isInCardioidOrBulb (const vec2 c)
+{
+    float x = c.x - 0.25;
+    float y2 = c.y * c.y;
+    float q = x * x + y2;
+    if (q * (q + x) <= 0.25 * y2)
+        return true;
+
+    return (c.x + 1.0) * (c.x + 1.0) + y2 <= 0.0625;
+}
+
 void main()
 {
     vec2 c = fragPos;
     vec2 z = fragPos;
     
+    if (isInCardioidOrBulb(c)) {
+        fragIter = float(maxIter);
+        return;
+    }
+    
+    /* Brent cycle detection: z is compared with a reference point of the orbit,
+     * which jumps to the current point after 1, 2, 4, 8... iterations.
+     * The orbit is periodic once it came back near the same reference point twice, see CycleDetector */
+    vec2 reference = z;
+    uint steps = 0u, period = 1u;
+    bool returned = false;
+    float tolerance2 = periodicityTolerance * periodicityTolerance;
+    
     uint currIter = 0u;
     while (currIter < maxIter) {
         if (length(z) > 2)
@@ -29,8 +56,28 @@ void main()
         z = complexProduct(z, z) + c;
         
         ++currIter;
+        
+        vec2 d = z - reference;
+        if (dot(d, d) <= tolerance2) {
+            if (returned) {
+                currIter = maxIter;
+                break;
+            }
+            returned = true;
+        }
+        if (++steps == period) {
+            steps = 0u;
+            period *= 2u;
+            reference = z;
+            returned = false;
+        }
     }
     
-    float r = float(currIter) / float(maxIter);
-    fragColor = texture(palette, vec2(r,0.5));
+    /* Escaped orbits add to their count a fraction below 1, 1 - log2(log2|z|) scaled down,
+     * which decreases as |z| grows past the bailout: floor() of the result is the count,
+     * and the result itself is continuous across the bands. Others get maxIter. */
+    float count = float(maxIter);
+    if (currIter < maxIter)
+        count = float(currIter) + 0.99 * clamp(1.0 - log2(log2(length(z))), 0.0, 1.0);
+    fragIter = count;
 }
@@ -0,0 +1,89 @@
+#version 150
+#extension GL_ARB_gpu_shader_fp64 : require
+
+
+/* mandelbrot.frag in native doubles, for the views too deep for floats, on GPUs that have them.
+ * See mandelbrot_df64.frag for the others.
+ */
+uniform uint maxIter;
+
+/* Orbits coming back that close to one of their previous points are considered periodic */
+uniform float periodicityTolerance;
+
+/* Origin of the view: invViewMatrix has no translation,
+ * and fragPos is the offset of the fragment from the origin, small enough for floats */
+uniform dvec2 origin;
+
+in vec2 fragPos;
+
+/* Iteration count, see the end of main() */
+out float fragIter;
+
+
+dvec2 complexProduct (const dvec2 a, const dvec2 b)
+{
+    return dvec2(a.x * b.x - a.y * b.y,
+                 a.x * b.y + a.y * b.x);
+}
+
+/* True if c lies in the main cardioid or in the period-2 bulb, where orbits never escape */
+bool isInCardioidOrBulb (const dvec2 c)
+{
+    double x = c.x - 0.25LF;
+    double y2 = c.y * c.y;
+    double q = x * x + y2;
+    if (q * (q + x) <= 0.25LF * y2)
+        return true;
+
+    return (c.x + 1.0LF) * (c.x + 1.0LF) + y2 <= 0.0625LF;
+}
+
+void main()
+{
+    dvec2 c = origin + dvec2(fragPos);
+    dvec2 z = c;
+    
+    if (isInCardioidOrBulb(c)) {
+        fragIter = float(maxIter);
+        return;
+    }
+    
+    /* Brent cycle detection: z is compared with a reference point of the orbit,
+     * which jumps to the current point after 1, 2, 4, 8... iterations.
+     * The orbit is periodic once it came back near the same reference point twice, see CycleDetector */
+    dvec2 reference = z;
+    uint steps = 0u, period = 1u;
+    bool returned = false;
+    double tolerance2 = double(periodicityTolerance) * double(periodicityTolerance);
+    
+    uint currIter = 0u;
+    while (currIter < maxIter) {
+        if (dot(z, z) > 4.0LF)
+            break;
+        
+        z = complexProduct(z, z) + c;
+        
+        ++currIter;
+        
+        dvec2 d = z - reference;
+        if (dot(d, d) <= tolerance2) {
+            if (returned) {
+                currIter = maxIter;
+                break;
+            }
+            returned = true;
+        }
+        if (++steps == period) {
+            steps = 0u;
+            period *= 2u;
+            reference = z;
+            returned = false;
+        }
+    }
+    
+    /* Same fraction as mandelbrot.frag: |z| is past the bailout, floats are enough */
+    float count = float(maxIter);
+    if (currIter < maxIter)
+        count = float(currIter) + 0.99 * clamp(1.0 - log2(log2(length(vec2(z)))), 0.0, 1.0);
+    fragIter = count;
+}
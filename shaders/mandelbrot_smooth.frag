@@ -1,38 +0,0 @@
-#version 130
-
-
-uniform sampler2D palette;
-
-uniform uint maxIter;
-
-in vec2 fragPos;
-
-out vec4 fragColor;
-
-
-vec2 complexProduct (const vec2 a, const vec2 b)
-{
-    return vec2(a.x * b.x - a.y * b.y,
-                a.x * b.y + a.y * b.x);
-}
-
-void main()
-{
-    vec2 c = fragPos;
-    vec2 z = fragPos;
-    
-    uint currIter = 0u;
-    while (currIter < maxIter) {
-        if (length(z) > 2)
-            break;
-        
-        z = complexProduct(z, z) + c;
-        
-        ++currIter;
-    }
-    
-    float fCurrIter = currIter - log(log(length(z))) / log(2);
-    
-    float r = float(fCurrIter) / float(maxIter);
-    fragColor = texture(palette, vec2(r,0.5));
-}
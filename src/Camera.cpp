@@ -2,88 +2,110 @@
 
 
 Camera::Camera (unsigned int screenWidth, unsigned screenHeight,
-                glm::vec2 const& origin,
-                float zoomLevel):
+                glm::dvec2 const& origin,
+                double zoomLevel):
             _origin (origin),
+            _anchor (origin),
+            _panPixels (0, 0),
             _zoomLevel (zoomLevel),
-            _aspectRatio (static_cast<float>(screenWidth) / static_cast<float>(screenHeight))
+            _aspectRatio (static_cast<double>(screenWidth) / static_cast<double>(screenHeight)),
+            _screenHeight (screenHeight)
 {
     computeInvViewMatrix();
 }
 
-glm::vec2 const& Camera::getOrigin() const
+glm::dvec2 const& Camera::getOrigin() const
 {
     return _origin;
 }
 
-glm::vec2 Camera::getViewSize() const
+glm::dvec2 Camera::getViewSize() const
 {
-    return glm::vec2(2*_aspectRatio,2) / _zoomLevel;
+    return glm::dvec2(2.0*_aspectRatio, 2.0) / _zoomLevel;
 }
 
-float Camera::getZoomLevel () const
+double Camera::getZoomLevel () const
 {
     return _zoomLevel;
 }
 
-glm::mat3 const& Camera::getInvViewMatrix() const
+glm::dvec2 const& Camera::getAnchor() const
+{
+    return _anchor;
+}
+
+glm::ivec2 const& Camera::getPanPixels() const
+{
+    return _panPixels;
+}
+
+glm::dmat3 const& Camera::getInvViewMatrix() const
 {
     return _invViewMatrix;
 }
 
 void Camera::setScreenSize(unsigned int screenWidth, unsigned int screenHeight)
 {
-    _aspectRatio = static_cast<float>(screenWidth) / static_cast<float>(screenHeight);
-    computeInvViewMatrix();
+    _aspectRatio = static_cast<double>(screenWidth) / static_cast<double>(screenHeight);
+    _screenHeight = screenHeight;
+    setAnchor(_origin);
 }
 
-void Camera::setOrigin (glm::vec2 const& newOrigin)
+void Camera::setOrigin (glm::dvec2 const& newOrigin)
 {
-    _origin = newOrigin;
-    computeInvViewMatrix();
+    setAnchor(newOrigin);
 }
 
-void Camera::setZoomLevel (float newZoomLevel)
+void Camera::setZoomLevel (double newZoomLevel)
 {
-    if (newZoomLevel == 0.f)
+    if (newZoomLevel == 0.0)
         return;
 
     _zoomLevel = newZoomLevel;
-    computeInvViewMatrix();
+    setAnchor(_origin);
 }
 
-void Camera::zoom(glm::vec2 const& towards, float factor)
+void Camera::zoom(glm::dvec2 const& towards, double factor)
 {
-    _origin = _origin * (factor + 1.f) - towards * factor;
-    _zoomLevel /= 1.f + factor;
-
-   computeInvViewMatrix();
+    /* Relative to towards, which keeps the offset exact whatever the magnitude of the origin */
+    _zoomLevel /= 1.0 + factor;
+    setAnchor(towards + (_origin - towards) * (1.0 + factor));
 }
 
 void Camera::relativeMovement(glm::vec2 const& movement)
 {
-    _origin += movement / _zoomLevel;
+    /* Pixels are square: one of them is as wide as it is high */
+    double pixelSize = getViewSize().y / static_cast<double>(_screenHeight);
+    glm::dvec2 offset = glm::dvec2(movement.x * _aspectRatio, movement.y) / _zoomLevel;
+    _panPixels += glm::ivec2(glm::round(offset / pixelSize));
+    _origin = _anchor + glm::dvec2(_panPixels) * pixelSize;
     computeInvViewMatrix();
 }
 
-glm::vec2 Camera::windowToWorld (glm::vec2 const& winPos)
+glm::dvec2 Camera::windowToWorld (glm::vec2 const& winPos) const
 {
-    glm::vec2 worldPos(winPos.x, winPos.y);
+    return glm::dvec2(_invViewMatrix * glm::dvec3(winPos.x, winPos.y, 1.0));
+}
 
-    return worldPos / _zoomLevel + _origin;
+void Camera::setAnchor (glm::dvec2 const& anchor)
+{
+    _origin = anchor;
+    _anchor = anchor;
+    _panPixels = glm::ivec2(0, 0);
+    computeInvViewMatrix();
 }
 
 void Camera::computeInvViewMatrix()
 {
     _invViewMatrix[0][0] = _aspectRatio / _zoomLevel;
-    _invViewMatrix[1][0] = 0.f;
+    _invViewMatrix[1][0] = 0.0;
     _invViewMatrix[2][0] = _origin.x;
 
-    _invViewMatrix[0][1] = 0.f;
-    _invViewMatrix[1][1] = 1.f / _zoomLevel;
+    _invViewMatrix[0][1] = 0.0;
+    _invViewMatrix[1][1] = 1.0 / _zoomLevel;
     _invViewMatrix[2][1] = _origin.y;
 
-    _invViewMatrix[0][2] = 0.f;
-    _invViewMatrix[1][2] = 0.f;
-    _invViewMatrix[2][2] = 0.f;
+    _invViewMatrix[0][2] = 0.0;
+    _invViewMatrix[1][2] = 0.0;
+    _invViewMatrix[2][2] = 0.0;
 }
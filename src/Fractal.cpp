@@ -1,21 +1,153 @@
 #include "Fractal.hpp"
 
 #include "GLHelper.hpp"
-
+#include "cpu/FixedPointKernel.hpp"
+#include "cpu/Pan.hpp"
+#include "cpu/RenderParameters.hpp"
+#include "cpu/Reprojection.hpp"
+#include "cpu/SIMDKernel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/RenderTexture.hpp>
 
 
+namespace
+{
+    /* Resolution divider of the first progressive pass of the CPU engine */
+    const unsigned int firstPassStep = 8;
+
+    /* Frames are rendered at full resolution at once, without progressive passes,
+     * while the full-resolution passes take less than this, in seconds
+     */
+    const double directRenderSeconds = 0.03;
+
+    /* Share of a new frame the last one has to cover to be resampled as a preview */
+    const double minPreviewCoverage = 0.5;
+
+    /* Duration each refinement of a preview aims at, in seconds */
+    const double refineSeconds = 0.03;
+
+    /* Share of the palette cycling shifts by each second */
+    const float paletteCyclesPerSecond = 0.1f;
+
+    /* Iterations each draw of the progressive GPU mode runs */
+    const unsigned int gpuSliceIterations = 128;
+
+    /* Size of the tiles of the tiled GPU mode, and the GPU time their draws aim at, in seconds */
+    const unsigned int gpuTileSize = 128;
+    const double gpuTileSeconds = 0.02;
+
+    /* Units of the textures bound by hand. SFML tracks unit 0 for its own drawings,
+     * and sf::Shader binds its textures from unit 1: the palette of the coloring pass */
+    const GLint iterationsTextureUnit = 2;
+    const GLint orbitsTextureUnit = 1;
+    const GLint cyclesTextureUnit = 2;
+
+    /* Sets the uniforms nameHi and nameLo of a double-float shader to the floats whose sum is value */
+    void setDoubleFloatUniform (GLuint shaderHandle, std::string const& name, glm::dvec2 const& value)
+    {
+        const glm::vec2 hi(value);
+        const glm::vec2 lo(value - glm::dvec2(hi));
+        GLCHECK(glUniform2f(getShaderUniformLoc(shaderHandle, name + "Hi", false), hi.x, hi.y));
+        GLCHECK(glUniform2f(getShaderUniformLoc(shaderHandle, name + "Lo", false), lo.x, lo.y));
+    }
+
+    /* Maps the corners of the viewport to the corners of an image covering it */
+    const glm::mat3 cornersToImage(0.5f, 0.f, 0.f,
+                                   0.f, 0.5f, 0.f,
+                                   0.5f, 0.5f, 1.f);
+
+    /* Texture sampled texel by texel */
+    GLuint createTexture()
+    {
+        GLuint textureID = 0;
+        GLCHECK(glGenTextures(1, &textureID));
+        GLCHECK(glBindTexture(GL_TEXTURE_2D, textureID));
+        GLCHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+        GLCHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+        GLCHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GLCHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        GLCHECK(glBindTexture(GL_TEXTURE_2D, 0));
+        return textureID;
+    }
+
+    /* Floating-point texture of undefined content */
+    void allocateTexture (GLuint textureID, GLint format, unsigned int width, unsigned int height)
+    {
+        GLenum components = (format == GL_R32F) ? GL_RED : GL_RGBA;
+        GLCHECK(glBindTexture(GL_TEXTURE_2D, textureID));
+        GLCHECK(glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, components, GL_FLOAT, nullptr));
+        GLCHECK(glBindTexture(GL_TEXTURE_2D, 0));
+    }
+
+    /* Binds a new framebuffer drawing to the textures, as its color attachments 0, 1...
+     * Framebuffers are not shared between OpenGL contexts, unlike textures: they are created
+     * for each draw, in the context of the window drawn to.
+     */
+    GLuint createFramebuffer (std::vector<GLuint> const& textureIDs)
+    {
+        GLuint framebufferID = 0;
+        GLCHECK(glGenFramebuffers(1, &framebufferID));
+        GLCHECK(glBindFramebuffer(GL_FRAMEBUFFER, framebufferID));
+
+        std::vector<GLenum> attachments;
+        for (std::size_t i = 0; i < textureIDs.size(); ++i) {
+            attachments.push_back(GL_COLOR_ATTACHMENT0 + i);
+            GLCHECK(glFramebufferTexture2D(GL_FRAMEBUFFER, attachments.back(), GL_TEXTURE_2D, textureIDs[i], 0));
+        }
+        GLCHECK(glDrawBuffers(attachments.size(), attachments.data()));
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            GLCHECK(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+            GLCHECK(glDeleteFramebuffers(1, &framebufferID));
+            throw std::runtime_error("Fractal: unable to render to floating-point textures");
+        }
+        return framebufferID;
+    }
+}
+
 Fractal::Fractal (Fractal::Type type, std::string const& palette):
             _type(type),
-            _seed(glm::vec2(0.f, 0.f)),
+            _seed(glm::dvec2(0.0, 0.0)),
             _maxIter(100),
             _cornersBufferID(-1),
-            _camera(1, 1, glm::vec2(0,0), 0.5f),
-            _needToRedraw(true)
+            _camera(1, 1, glm::dvec2(0,0), 0.5),
+            _needToRedraw(true),
+            _needToRecolor(false),
+            _paletteCycling(false),
+            _paletteOffset(0.f),
+            _smoothColoring(false),
+            _iterationsTextureID(-1),
+            _iterationsWidth(0),
+            _iterationsHeight(0),
+            _progressiveGPU(false),
+            _orbitsSource(0),
+            _orbitsIterations(0),
+            _tiledGPU(false),
+            _gpuTimedPixels(0.0),
+            _gpuPixelsPerSecond(0.0),
+            _cpuRendering(false),
+            _floatKernel(new SIMDKernel<float>(LaneMode::Refill)), //refill copes best with the scattered pixels of the sparse render modes
+            _doubleKernel(new SIMDKernel<double>(LaneMode::Refill)),
+            _doubleDoubleKernel(new SIMDKernel<DoubleDouble>(LaneMode::Refill)),
+            _fixedPointKernel(new FixedPointKernel()),
+            _renderer(*_floatKernel),
+            _cpuPalette(Palette::grayscale()),
+            _passStep(1),
+            _nextPassStep(0),
+            _fullPassSeconds(0.0),
+            _frameValid(false),
+            _framePrecision(Precision::Float),
+            _pixelsPerSecond(0.0)
 {
     std::string vertex, fragment;
     vertex = "shaders/fractal.vert";
@@ -28,10 +160,43 @@ Fractal::Fractal (Fractal::Type type, std::string const& palette):
         throw std::runtime_error("Fractal: unable to load shader " + vertex + " or " + fragment);
     }
 
-    if (!_palette.loadFromFile(palette)) {
-        throw std::runtime_error("Fractal: unable to load " + palette);
+    loadPalette(palette);
+
+    _gpuPrecision.add(Precision::Float);
+    vertex = "shaders/fractal.vert";
+    if (GLEW_ARB_gpu_shader_fp64) {
+        _gpuPrecision.add(Precision::Double);
+        fragment = (type == Type::Mandelbrot) ? "shaders/mandelbrot_fp64.frag" : "shaders/julia_fp64.frag";
+    } else {
+        _gpuPrecision.add(Precision::DoubleFloat);
+        fragment = (type == Type::Mandelbrot) ? "shaders/mandelbrot_df64.frag" : "shaders/julia_df64.frag";
+    }
+
+    if (!_deepShader.loadFromFile(vertex, fragment)) {
+        throw std::runtime_error("Fractal: unable to load shader " + vertex + " or " + fragment);
+    }
+
+    vertex = "shaders/fractal.vert";
+    if (type == Type::Mandelbrot)
+        fragment = "shaders/mandelbrot_progressive.frag";
+    else
+        fragment = "shaders/julia_progressive.frag";
+
+    if (!_progressiveShader.loadFromFile(vertex, fragment)) {
+        throw std::runtime_error("Fractal: unable to load shader " + vertex + " or " + fragment);
+    }
+
+    vertex = "shaders/fractal.vert";
+    fragment = "shaders/coloring.frag";
+    if (!_coloringShader.loadFromFile(vertex, fragment)) {
+        throw std::runtime_error("Fractal: unable to load shader " + vertex + " or " + fragment);
+    }
+
+    vertex = "shaders/fractal.vert";
+    fragment = "shaders/image.frag";
+    if (!_imageShader.loadFromFile(vertex, fragment)) {
+        throw std::runtime_error("Fractal: unable to load shader " + vertex + " or " + fragment);
     }
-    _palette.setSmooth(true);
 
     /* Buffer allocation */
     std::vector<glm::vec2> corners(6);
@@ -47,6 +212,18 @@ Fractal::Fractal (Fractal::Type type, std::string const& palette):
     GLCHECK(glBufferData(GL_ARRAY_BUFFER, corners.size()*sizeof(glm::vec2), corners.data(), GL_STATIC_DRAW));
 
     GLCHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+    _cpuPrecision.add(Precision::Float);
+    _cpuPrecision.add(Precision::Double);
+    _cpuPrecision.add(Precision::DoubleDouble);
+    _cpuPrecision.add(Precision::Fixed128);
+
+    /* Iteration counts and orbits, allocated at the size of the viewport by drawGPU() */
+    _iterationsTextureID = createTexture();
+    for (unsigned int i = 0; i < 2; ++i) {
+        _orbitsTextureIDs[i] = createTexture();
+        _cyclesTextureIDs[i] = createTexture();
+    }
 }
 
 Fractal::~Fractal()
@@ -54,48 +231,462 @@ Fractal::~Fractal()
     if (_cornersBufferID != (GLuint)(-1)) {
         GLCHECK(glDeleteBuffers(1, &_cornersBufferID));
     }
+    if (_iterationsTextureID != (GLuint)(-1)) {
+        GLCHECK(glDeleteTextures(1, &_iterationsTextureID));
+    }
+    GLCHECK(glDeleteTextures(2, _orbitsTextureIDs));
+    GLCHECK(glDeleteTextures(2, _cyclesTextureIDs));
+}
+
+void Fractal::loadPalette (std::string const& palette)
+{
+    sf::Image paletteImage;
+    if (!paletteImage.loadFromFile(palette) || !_palette.loadFromImage(paletteImage)) {
+        throw std::runtime_error("Fractal: unable to load " + palette);
+    }
+    _palette.setSmooth(true);
+    _cpuPalette = Palette(paletteImage.getPixelsPtr(), paletteImage.getSize().x);
+    _paletteFile = palette;
 }
 
 bool Fractal::needToRedraw() const
 {
-    return _needToRedraw;
+    return _needToRedraw || _needToRecolor || _paletteCycling || isRefining();
+}
+
+bool Fractal::isRefining() const
+{
+    if (!_cpuRendering)
+        return !_needToRedraw && ((_progressiveGPU && _orbitsIterations < getMaxIter()) || !_gpuTiles.empty());
+
+    return !_needToRedraw && (_nextPassStep != 0 || !_pendingTiles.empty());
 }
 
 void Fractal::draw () const
 {
+    bool newFrame = _needToRedraw;
     _needToRedraw = false;
+    _needToRecolor = false;
+
+    if (_paletteCycling) {
+        float shift = paletteCyclesPerSecond * _paletteClock.restart().asSeconds();
+        _paletteOffset = std::fmod(_paletteOffset + shift, 1.f);
+    }
 
     GLCHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
 
-    _shader.setParameter("palette", _palette);
-    sf::Shader::bind(&_shader);
+    if (_cpuRendering) {
+        drawCPU(newFrame);
+    } else {
+        /* The CPU frame goes stale, whether complete or not */
+        _nextPassStep = 0;
+        _pendingTiles.clear();
+        _frameValid = false;
+        drawGPU(newFrame);
+    }
+}
 
-    /* First retrieve locations */
-    GLuint shaderHandle = -1;
-    GLuint cornerALoc = -1;
-    GLuint maxIterULoc = -1, matrixULoc = -1;
+void Fractal::drawGPU (bool newFrame) const
+{
+    GLint viewport[4];
+    GLCHECK(glGetIntegerv(GL_VIEWPORT, viewport));
+    unsigned int width = viewport[2], height = viewport[3];
+    if (width == 0 || height == 0)
+        return;
+
+    if (_iterationsWidth != width || _iterationsHeight != height) {
+        allocateTexture(_iterationsTextureID, GL_R32F, width, height);
+        for (unsigned int i = 0; i < 2; ++i) {
+            allocateTexture(_orbitsTextureIDs[i], GL_RGBA32F, width, height);
+            allocateTexture(_cyclesTextureIDs[i], GL_RGBA32F, width, height);
+        }
+        _orbitsIterations = 0;
+
+        _iterationsWidth = width;
+        _iterationsHeight = height;
+        newFrame = true;
+    }
 
-//    try {
-        shaderHandle = getShaderHandle(_shader, false);
+    if (!_tiledGPU || _progressiveGPU) {
+        _gpuTiles.clear();
+    }
 
-        maxIterULoc = getShaderUniformLoc(shaderHandle, "maxIter", false);
-        matrixULoc = getShaderUniformLoc(shaderHandle, "invViewMatrix", false);
+    /* The cheapest shader that resolves the view. Tiles still to draw are of the same view, so of the same shader. */
+    RenderParameters view;
+    view.invViewMatrix = _camera.getInvViewMatrix();
+    view.anchor = _camera.getAnchor();
+    view.panPixels = _camera.getPanPixels();
+    _gpuPrecision.select(view, width, height);
+
+    if (_progressiveGPU) {
+        stepIterationsGPU(newFrame, viewport);
+    } else if (_tiledGPU) {
+        if (newFrame) {
+            _gpuTiles = splitInTiles(width, height, gpuTileSize);
+            auto distance = [width, height](Tile const& tile) {
+                double dx = (tile.x + 0.5 * tile.width) - 0.5 * width;
+                double dy = (tile.y + 0.5 * tile.height) - 0.5 * height;
+                return dx * dx + dy * dy;
+            };
+            std::stable_sort(_gpuTiles.begin(), _gpuTiles.end(), [&distance](Tile const& a, Tile const& b) {
+                return distance(a) < distance(b);
+            });
+        }
+        if (!_gpuTiles.empty()) {
+            drawTilesGPU(viewport);
+        }
+    } else if (newFrame) {
+        drawIterationsGPU(viewport, std::vector<Tile>(1, Tile{0, 0, width, height}));
+    }
 
+    /* Coloring pass */
+    _coloringShader.setParameter("palette", _palette);
+    sf::Shader::bind(&_coloringShader);
 
-        cornerALoc = getShaderAttributeLoc(shaderHandle, "corner", false);
-//    } catch (std::exception const& e) {
-//        std::cerr << "Renderer2D.draw: " << e.what() << std::endl;
-//        return;
-//    }
+    GLuint shaderHandle = getShaderHandle(_coloringShader, false);
+    GLuint iterationsULoc = getShaderUniformLoc(shaderHandle, "iterations", false);
+    GLuint maxIterULoc = getShaderUniformLoc(shaderHandle, "maxIter", false);
+    GLuint offsetULoc = getShaderUniformLoc(shaderHandle, "paletteOffset", false);
+    GLuint smoothULoc = getShaderUniformLoc(shaderHandle, "smoothColoring", false);
+    GLuint matrixULoc = getShaderUniformLoc(shaderHandle, "invViewMatrix", false);
 
-    if (_type == Type::Julia) {
-        GLuint seedULoc = -1;
-        seedULoc = getShaderUniformLoc(shaderHandle, "c", false);
-        GLCHECK(glUniform2f(seedULoc, _seed.x, _seed.y));
+    GLCHECK(glActiveTexture(GL_TEXTURE0 + iterationsTextureUnit));
+    GLCHECK(glBindTexture(GL_TEXTURE_2D, _iterationsTextureID));
+    GLCHECK(glUniform1i(iterationsULoc, iterationsTextureUnit));
+    GLCHECK(glUniform1ui(maxIterULoc, getMaxIter()));
+    GLCHECK(glUniform1f(offsetULoc, _paletteOffset));
+    GLCHECK(glUniform1i(smoothULoc, _smoothColoring));
+    GLCHECK(glUniformMatrix3fv(matrixULoc, 1, GL_FALSE, &cornersToImage[0][0]));
+
+    drawCorners(shaderHandle);
+
+    GLCHECK(glBindTexture(GL_TEXTURE_2D, 0));
+    GLCHECK(glActiveTexture(GL_TEXTURE0));
+    sf::Shader::bind(0);
+}
+
+void Fractal::drawIterationsGPU (GLint const* viewport, std::vector<Tile> const& tiles) const
+{
+    GLint previousFramebuffer = 0;
+    GLCHECK(glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer));
+    GLuint framebufferID = createFramebuffer(std::vector<GLuint>(1, _iterationsTextureID));
+    GLCHECK(glViewport(0, 0, viewport[2], viewport[3]));
+
+    const Precision precision = _gpuPrecision.getPrecision();
+    sf::Shader& shader = (precision == Precision::Float) ? _shader : _deepShader;
+    sf::Shader::bind(&shader);
+
+    GLuint shaderHandle = getShaderHandle(shader, false);
+    setFractalUniforms(shaderHandle, viewport, precision);
+
+    GLCHECK(glEnable(GL_SCISSOR_TEST));
+    for (Tile const& tile : tiles) {
+        GLCHECK(glScissor(tile.x, tile.y, tile.width, tile.height));
+        drawCorners(shaderHandle);
+    }
+    GLCHECK(glDisable(GL_SCISSOR_TEST));
+    sf::Shader::bind(0);
+
+    GLCHECK(glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer));
+    GLCHECK(glDeleteFramebuffers(1, &framebufferID));
+    GLCHECK(glViewport(viewport[0], viewport[1], viewport[2], viewport[3]));
+}
+
+void Fractal::drawTilesGPU (GLint const* viewport) const
+{
+    /* Measures come a draw or more after their tiles */
+    double seconds = 0.0;
+    if (_gpuTimer.poll(seconds) && seconds > 0.0)
+        _gpuPixelsPerSecond = _gpuTimedPixels / seconds;
+
+    /* As many tiles as the last measure suggests fit in the time budget, at least one */
+    double budget = _gpuPixelsPerSecond * gpuTileSeconds, pixels = 0.0;
+    std::size_t count = 0;
+    for (; count < _gpuTiles.size(); ++count) {
+        double tilePixels = static_cast<double>(_gpuTiles[count].width) * _gpuTiles[count].height;
+        if (count > 0 && pixels + tilePixels > budget)
+            break;
+        pixels += tilePixels;
     }
 
+    std::vector<Tile> batch(_gpuTiles.begin(), _gpuTiles.begin() + count);
+    _gpuTiles.erase(_gpuTiles.begin(), _gpuTiles.begin() + count);
+
+    const bool timed = !_gpuTimer.isPending();
+    if (timed)
+        _gpuTimer.start();
+    drawIterationsGPU(viewport, batch);
+    if (timed) {
+        _gpuTimer.stop();
+        _gpuTimedPixels = pixels;
+    }
+}
+
+void Fractal::stepIterationsGPU (bool newFrame, GLint const* viewport) const
+{
+    RenderParameters parameters;
+    parameters.type = _type;
+    parameters.seed = _seed;
+    parameters.maxIter = getMaxIter();
+    parameters.invViewMatrix = _camera.getInvViewMatrix();
+    parameters.anchor = _camera.getAnchor();
+    parameters.panPixels = _camera.getPanPixels();
+
+    /* The orbits of the same view carry on whatever maxIter */
+    RenderParameters orbits = _orbitsParameters;
+    orbits.maxIter = parameters.maxIter;
+    const bool restart = (_orbitsIterations == 0 || !isSameFractal(orbits, parameters)
+                          || !isSameView(orbits, parameters));
+    if (restart) {
+        _orbitsIterations = 0;
+    } else if (!newFrame && _orbitsIterations >= parameters.maxIter) {
+        return; //the counts are up to date
+    }
+
+    const unsigned int source = _orbitsSource, target = 1 - source;
+
+    GLint previousFramebuffer = 0;
+    GLCHECK(glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer));
+    std::vector<GLuint> textures = {_orbitsTextureIDs[target], _cyclesTextureIDs[target], _iterationsTextureID};
+    GLuint framebufferID = createFramebuffer(textures);
+    GLCHECK(glViewport(0, 0, viewport[2], viewport[3]));
+
+    sf::Shader::bind(&_progressiveShader);
+
+    GLuint shaderHandle = getShaderHandle(_progressiveShader, false);
+    setFractalUniforms(shaderHandle, viewport, Precision::Float);
+
+    GLuint orbitsULoc = getShaderUniformLoc(shaderHandle, "orbits", false);
+    GLuint cyclesULoc = getShaderUniformLoc(shaderHandle, "cycles", false);
+    GLuint restartULoc = getShaderUniformLoc(shaderHandle, "restart", false);
+    GLuint sliceULoc = getShaderUniformLoc(shaderHandle, "sliceIter", false);
+
+    GLCHECK(glActiveTexture(GL_TEXTURE0 + orbitsTextureUnit));
+    GLCHECK(glBindTexture(GL_TEXTURE_2D, _orbitsTextureIDs[source]));
+    GLCHECK(glActiveTexture(GL_TEXTURE0 + cyclesTextureUnit));
+    GLCHECK(glBindTexture(GL_TEXTURE_2D, _cyclesTextureIDs[source]));
+    GLCHECK(glUniform1i(orbitsULoc, orbitsTextureUnit));
+    GLCHECK(glUniform1i(cyclesULoc, cyclesTextureUnit));
+    GLCHECK(glUniform1i(restartULoc, restart));
+    GLCHECK(glUniform1ui(sliceULoc, gpuSliceIterations));
+
+    drawCorners(shaderHandle);
+
+    GLCHECK(glBindTexture(GL_TEXTURE_2D, 0));
+    GLCHECK(glActiveTexture(GL_TEXTURE0 + orbitsTextureUnit));
+    GLCHECK(glBindTexture(GL_TEXTURE_2D, 0));
+    GLCHECK(glActiveTexture(GL_TEXTURE0));
+    sf::Shader::bind(0);
+
+    GLCHECK(glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer));
+    GLCHECK(glDeleteFramebuffers(1, &framebufferID));
+    GLCHECK(glViewport(viewport[0], viewport[1], viewport[2], viewport[3]));
+
+    _orbitsSource = target;
+    _orbitsParameters = parameters;
+    if (_orbitsIterations < parameters.maxIter)
+        _orbitsIterations = std::min(_orbitsIterations + gpuSliceIterations, parameters.maxIter);
+}
+
+void Fractal::setFractalUniforms (GLuint shaderHandle, GLint const* viewport, Precision precision) const
+{
+    GLuint maxIterULoc = getShaderUniformLoc(shaderHandle, "maxIter", false);
+    GLuint matrixULoc = getShaderUniformLoc(shaderHandle, "invViewMatrix", false);
+    GLuint toleranceULoc = getShaderUniformLoc(shaderHandle, "periodicityTolerance", false);
+
+    glm::dmat3 invViewMatrix = _camera.getInvViewMatrix();
+    if (precision == Precision::Float) {
+        /* The shaders compute in floats */
+        if (_type == Type::Julia) {
+            GLuint seedULoc = getShaderUniformLoc(shaderHandle, "c", false);
+            GLCHECK(glUniform2f(seedULoc, static_cast<float>(_seed.x), static_cast<float>(_seed.y)));
+        }
+    } else {
+        /* The deep shaders add the origin of the view, in their own format,
+         * to the offset of the fragment from it, which floats hold well enough */
+        const glm::dvec2 origin(invViewMatrix[2][0], invViewMatrix[2][1]);
+        invViewMatrix[2] = glm::dvec3(0.0, 0.0, 1.0);
+
+        if (precision == Precision::Double) {
+            GLCHECK(glUniform2d(getShaderUniformLoc(shaderHandle, "origin", false), origin.x, origin.y));
+            if (_type == Type::Julia) {
+                GLCHECK(glUniform2d(getShaderUniformLoc(shaderHandle, "c", false), _seed.x, _seed.y));
+            }
+        } else {
+            GLuint zeroULoc = getShaderUniformLoc(shaderHandle, "zero", false);
+            GLCHECK(glUniform1f(zeroULoc, 0.f));
+            setDoubleFloatUniform(shaderHandle, "origin", origin);
+            if (_type == Type::Julia) {
+                setDoubleFloatUniform(shaderHandle, "c", _seed);
+            }
+        }
+    }
+
+    const glm::mat3 matrix(invViewMatrix);
     GLCHECK(glUniform1ui(maxIterULoc, getMaxIter()));
-    GLCHECK(glUniformMatrix3fv(matrixULoc, 1, GL_FALSE, &_camera.getInvViewMatrix()[0][0]));
+    GLCHECK(glUniformMatrix3fv(matrixULoc, 1, GL_FALSE, &matrix[0][0]));
+
+    /* Cycle detection tolerance is a fraction of the pixel size */
+    float pixelSize = static_cast<float>(_camera.getViewSize().y / viewport[3]);
+    GLCHECK(glUniform1f(toleranceULoc, defaultPeriodicityTolerance * pixelSize));
+}
+
+void Fractal::drawCPU (bool newFrame) const
+{
+    /* One pixel of the CPU render per pixel of the viewport */
+    GLint viewport[4];
+    GLCHECK(glGetIntegerv(GL_VIEWPORT, viewport));
+    unsigned int width = viewport[2], height = viewport[3];
+    if (width == 0 || height == 0)
+        return;
+
+    if (_iterations.getWidth() != width || _iterations.getHeight() != height) {
+        _iterations.resize(width, height);
+        _image.create(width, height);
+        newFrame = true;
+        _frameValid = false;
+    }
+
+    RenderParameters parameters;
+    parameters.type = _type;
+    parameters.seed = _seed;
+    parameters.maxIter = getMaxIter();
+    parameters.invViewMatrix = _camera.getInvViewMatrix();
+    parameters.anchor = _camera.getAnchor();
+    parameters.panPixels = _camera.getPanPixels();
+
+    /* The cheapest kernel that resolves the view. Its pixels would differ from those of another tier:
+     * the last frame is only kept as a preview, which is then rendered again in full.
+     */
+    if (_cpuPrecision.select(parameters, width, height)) {
+        switch (_cpuPrecision.getPrecision()) {
+            case Precision::Double:
+                _renderer.setKernel(*_doubleKernel);
+            break;
+            case Precision::DoubleDouble:
+                _renderer.setKernel(*_doubleDoubleKernel);
+            break;
+            case Precision::Fixed128:
+                _renderer.setKernel(*_fixedPointKernel);
+            break;
+            default:
+                _renderer.setKernel(*_floatKernel);
+            break;
+        }
+        _orbits.clear();
+    }
+    const bool samePrecision = (_framePrecision == _cpuPrecision.getPrecision());
+
+    /* Without a new frame, a complete one is only colored again.
+     * A pan of the last frame keeps its pixels, at full resolution, and so does a change of maxIter.
+     * Other moves start from a preview
+     * resampled from the last frame, if it covers enough of the new one, then refine it tile by tile.
+     * Otherwise each pass keeps the pixels of the previous one.
+     */
+    const bool complete = (_nextPassStep == 0 && _pendingTiles.empty());
+    const bool reusable = newFrame && _frameValid && complete && samePrecision;
+    Pan pan;
+    if (!newFrame && _frameValid && complete) {
+        parameters = _frameParameters;
+    } else if (reusable && findPan(_frameParameters, parameters, width, height, pan)) {
+        _renderer.render(parameters, applyPan(pan, _iterations), _iterations);
+        _passStep = 1;
+        _nextPassStep = 0;
+    } else if (reusable && resumeFrame(parameters)) {
+        _passStep = 1;
+        _nextPassStep = 0;
+    } else if (newFrame && _frameValid && drawPreview(parameters)) {
+        _passStep = 1;
+        _nextPassStep = 0;
+    } else if (!newFrame && !_pendingTiles.empty()) {
+        refinePreview(parameters);
+    } else {
+        if (newFrame || _nextPassStep == 0) {
+            const bool direct = (_fullPassSeconds > 0.0 && _fullPassSeconds < directRenderSeconds);
+            parameters.step = direct ? 1 : firstPassStep;
+            parameters.knownStep = 0;
+        } else {
+            parameters.step = _nextPassStep;
+            parameters.knownStep = _passStep;
+        }
+        _pendingTiles.clear();
+        _renderer.render(parameters, _iterations);
+        _passStep = parameters.step;
+        _nextPassStep = _passStep / 2;
+        if (_passStep == 1)
+            _fullPassSeconds = _renderer.getStats().seconds;
+    }
+    _cpuPalette.colorize(_iterations, parameters.maxIter, _rgba, _paletteOffset);
+    _frameParameters = parameters;
+    _frameValid = true;
+    _framePrecision = _cpuPrecision.getPrecision();
+    _image.update(_rgba.data());
+
+    _imageShader.setParameter("image", _image);
+    sf::Shader::bind(&_imageShader);
+
+    GLuint shaderHandle = getShaderHandle(_imageShader, false);
+    GLuint matrixULoc = getShaderUniformLoc(shaderHandle, "invViewMatrix", false);
+    GLCHECK(glUniformMatrix3fv(matrixULoc, 1, GL_FALSE, &cornersToImage[0][0]));
+
+    drawCorners(shaderHandle);
+    sf::Shader::bind(0);
+}
+
+bool Fractal::resumeFrame (RenderParameters const& parameters) const
+{
+    RenderParameters frame = _frameParameters;
+    frame.maxIter = parameters.maxIter;
+    if (!isSameFractal(frame, parameters) || !isSameView(frame, parameters))
+        return false;
+
+    /* The cache is only filled once maxIter changes, and holds the frame as long as nothing else does */
+    if (!_orbits.holds(_frameParameters) || _orbits.getParameters().maxIter != _frameParameters.maxIter)
+        _orbits.reset(_frameParameters, _iterations);
+
+    _renderer.resume(parameters, _orbits, _iterations);
+    return true;
+}
+
+bool Fractal::drawPreview (RenderParameters const& parameters) const
+{
+    if (!isSameFractal(_frameParameters, parameters))
+        return false;
+
+    std::swap(_iterations, _previousIterations);
+    _iterations.resize(_previousIterations.getWidth(), _previousIterations.getHeight());
+    Reprojection reprojection = reproject(_frameParameters, _previousIterations, parameters, _iterations,
+                                          _renderer.getTileSize());
+    if (reprojection.coverage < minPreviewCoverage)
+        return false;
+
+    _pendingTiles.swap(reprojection.tiles);
+    return true;
+}
+
+void Fractal::refinePreview (RenderParameters const& parameters) const
+{
+    /* As many tiles as the last renders suggest fit in the time budget, at least one */
+    double budget = _pixelsPerSecond * refineSeconds, pixels = 0.0;
+    std::size_t count = 0;
+    for (; count < _pendingTiles.size(); ++count) {
+        pixels += static_cast<double>(_pendingTiles[count].width) * _pendingTiles[count].height;
+        if (count > 0 && pixels > budget)
+            break;
+    }
+
+    std::vector<Tile> batch(_pendingTiles.begin(), _pendingTiles.begin() + count);
+    _pendingTiles.erase(_pendingTiles.begin(), _pendingTiles.begin() + count);
+    _renderer.render(parameters, batch, _iterations);
+
+    RenderStats const& stats = _renderer.getStats();
+    if (stats.seconds > 0.0)
+        _pixelsPerSecond = static_cast<double>(stats.pixels) / stats.seconds;
+}
+
+void Fractal::drawCorners (GLuint shaderHandle) const
+{
+    GLuint cornerALoc = getShaderAttributeLoc(shaderHandle, "corner", false);
 
     /* Enabling corners coordinates buffer */
     GLCHECK(glBindBuffer(GL_ARRAY_BUFFER, _cornersBufferID));
@@ -112,12 +703,11 @@ void Fractal::draw () const
     /* Don't forget to unbind buffers */
     GLCHECK(glDisableVertexAttribArray(cornerALoc));
     GLCHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
-    sf::Shader::bind(0);
 }
 
 void Fractal::saveToFile(std::string const& filepath) const
 {
-    float aspectRatio = getCamera().getViewSize().x / getCamera().getViewSize().y;
+    float aspectRatio = static_cast<float>(getCamera().getViewSize().x / getCamera().getViewSize().y);
     float height = 3000.f, width = height * aspectRatio;
 
     sf::RenderTexture texture;
@@ -125,6 +715,9 @@ void Fractal::saveToFile(std::string const& filepath) const
     texture.setActive(true);
     glViewport(0, 0, width, height);
     draw();
+    while (isRefining()) {
+        draw();
+    }
     texture.display();
     sf::Image image = texture.getTexture().copyToImage();
     image.saveToFile(filepath);
@@ -163,23 +756,147 @@ unsigned int Fractal::getMaxIter() const
     return _maxIter;
 }
 
-void Fractal::setSeed(glm::vec2 seed)
+void Fractal::setSeed(glm::dvec2 seed)
 {
     _needToRedraw = (_type == Type::Julia);
     _seed = seed;
 }
 
+void Fractal::setPalette (std::string const& palette)
+{
+    loadPalette(palette);
+    _needToRecolor = true;
+}
+
+std::string const& Fractal::getPalette() const
+{
+    return _paletteFile;
+}
+
+void Fractal::setPaletteCycling (bool paletteCycling)
+{
+    _paletteCycling = paletteCycling;
+    _paletteClock.restart();
+}
+
+bool Fractal::isPaletteCycling() const
+{
+    return _paletteCycling;
+}
+
+void Fractal::setSmoothColoring (bool smoothColoring)
+{
+    _needToRecolor = _needToRecolor || (_smoothColoring != smoothColoring);
+    _smoothColoring = smoothColoring;
+}
+
+bool Fractal::isSmoothColoring() const
+{
+    return _smoothColoring;
+}
+
+void Fractal::setProgressiveGPU (bool progressiveGPU)
+{
+    _needToRedraw = _needToRedraw || (!_cpuRendering && _progressiveGPU != progressiveGPU);
+    _progressiveGPU = progressiveGPU;
+}
+
+bool Fractal::isProgressiveGPU() const
+{
+    return _progressiveGPU;
+}
+
+void Fractal::setTiledGPU (bool tiledGPU)
+{
+    _needToRedraw = _needToRedraw || (!_cpuRendering && _tiledGPU != tiledGPU);
+    _tiledGPU = tiledGPU;
+}
+
+bool Fractal::isTiledGPU() const
+{
+    return _tiledGPU;
+}
+
+void Fractal::setCPURendering (bool cpuRendering)
+{
+    _needToRedraw = (_cpuRendering != cpuRendering);
+    _cpuRendering = cpuRendering;
+}
+
+bool Fractal::isCPURendering() const
+{
+    return _cpuRendering;
+}
+
+void Fractal::setRenderMode (RenderMode mode)
+{
+    _needToRedraw = _cpuRendering && (_renderer.getRenderMode() != mode);
+    _frameValid = _frameValid && !_needToRedraw;
+    if (_needToRedraw)
+        _orbits.clear();
+    _renderer.setRenderMode(mode);
+}
+
+RenderMode Fractal::getRenderMode() const
+{
+    return _renderer.getRenderMode();
+}
+
 std::string Fractal::getInfoString() const
 {
     std::stringstream stream;
+    const std::streamsize defaultPrecision = stream.precision();
     stream << "max iteration: " << getMaxIter() << " (A/E)" << std::endl;
     stream << "zoom: " << getCamera().getZoomLevel() << std::endl << std::endl;
 
+    if (_cpuRendering) {
+        RenderStats const& stats = _renderer.getStats();
+        stream << "renderer: CPU, " << getRenderModeName(getRenderMode()) << " (C/M)" << std::endl;
+        stream << "computed: " << static_cast<int>(100.0 * stats.getComputedFraction() + 0.5) << "% in "
+               << static_cast<int>(1000.0 * stats.seconds) << " ms";
+        if (_passStep > 1)
+            stream << ", 1/" << _passStep << " resolution";
+        else if (!_pendingTiles.empty())
+            stream << ", " << _pendingTiles.size() << " tiles to refine";
+        stream << std::endl;
+        stream << "precision: " << getPrecisionName(_framePrecision)
+               << (_cpuPrecision.resolvesView() ? "" : ", too coarse for this zoom") << std::endl << std::endl;
+    } else {
+        stream << "renderer: GPU" << (_progressiveGPU ? ", progressive" : (_tiledGPU ? ", tiled" : "")) << ", "
+               << (_smoothColoring ? "smooth" : "banded") << " coloring (C/G/T/B)" << std::endl;
+        if (_progressiveGPU)
+            stream << "iterated: " << std::min(_orbitsIterations, getMaxIter()) << " of " << getMaxIter() << std::endl;
+        else if (!_gpuTiles.empty())
+            stream << _gpuTiles.size() << " tiles to draw" << std::endl;
+
+        /* The progressive shaders keep their orbits in float textures */
+        bool resolved = _gpuPrecision.resolvesView();
+        Precision precision = _gpuPrecision.getPrecision();
+        if (_progressiveGPU) {
+            RenderParameters view;
+            view.invViewMatrix = _camera.getInvViewMatrix();
+            view.anchor = _camera.getAnchor();
+            view.panPixels = _camera.getPanPixels();
+            resolved = (_iterationsWidth == 0 ||
+                        getPixelUlps(Precision::Float, view, _iterationsWidth, _iterationsHeight) >= minPixelUlps);
+            precision = Precision::Float;
+        }
+        stream << "precision: " << getPrecisionName(precision) << (resolved ? "" : ", too coarse for this zoom")
+               << std::endl << std::endl;
+    }
+
+    stream << "palette: " << _paletteFile << (_paletteCycling ? ", cycling" : "") << " (P/O)" << std::endl << std::endl;
+
     if (_type == Type::Julia) {
-        stream << "seed: " << _seed.x << " ; " << _seed.y << std::endl << std::endl;
+        stream << std::setprecision(std::numeric_limits<double>::max_digits10)
+               << "seed: " << _seed.x << " ; " << _seed.y << std::endl << std::endl
+               << std::setprecision(defaultPrecision);
     }
 
-    stream << "origin: (" << getCamera().getOrigin().x << " ; " << getCamera().getOrigin().y << ")" << std::endl;
+    /* Enough digits to tell apart the origins of views one pixel apart, whatever the zoom */
+    stream << std::setprecision(std::numeric_limits<double>::max_digits10)
+           << "origin: (" << getCamera().getOrigin().x << " ; " << getCamera().getOrigin().y << ")" << std::endl
+           << std::setprecision(defaultPrecision);
     stream << "width:  " << getCamera().getViewSize().x << std::endl;
     stream << "height: " << getCamera().getViewSize().y;
 
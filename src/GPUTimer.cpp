@@ -0,0 +1,69 @@
+#include "GPUTimer.hpp"
+
+#include "GLHelper.hpp"
+
+
+GPUTimer::GPUTimer():
+            _fences(GLEW_ARB_sync),
+            _fence(nullptr),
+            _seconds(0.0),
+            _pending(false)
+{
+}
+
+GPUTimer::~GPUTimer()
+{
+    if (_fence != nullptr) {
+        GLCHECK(glDeleteSync(_fence));
+    }
+}
+
+void GPUTimer::start()
+{
+    if (_fence != nullptr) {
+        GLCHECK(glDeleteSync(_fence));
+        _fence = nullptr;
+    }
+    if (!_fences) {
+        GLCHECK(glFinish()); //so that only the commands of the measure are waited for
+    }
+
+    _clock.restart();
+    _pending = true;
+}
+
+void GPUTimer::stop()
+{
+    if (_fences) {
+        _fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        GLCHECK(glFlush()); //the fence has to reach the GPU to ever be signaled
+    } else {
+        GLCHECK(glFinish());
+        _seconds = _clock.getElapsedTime().asSeconds();
+    }
+}
+
+bool GPUTimer::isPending() const
+{
+    return _pending;
+}
+
+bool GPUTimer::poll (double& seconds)
+{
+    if (!_pending)
+        return false;
+
+    if (_fences) {
+        GLenum status = glClientWaitSync(_fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            return false;
+
+        _seconds = _clock.getElapsedTime().asSeconds();
+        GLCHECK(glDeleteSync(_fence));
+        _fence = nullptr;
+    }
+
+    _pending = false;
+    seconds = _seconds;
+    return true;
+}
@@ -0,0 +1,231 @@
+#include "cpu/BoundaryTrace.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+    /* Contours are followed by square blocks of pixels rather than pixel by pixel:
+     * each step then hands a whole vector of pixels to the kernel, and fewer steps are needed. */
+    const unsigned int blockSize = 4;
+
+    enum : std::uint8_t
+    {
+        Unknown = 0,
+        Queued = 1,
+        Computed = 2, //with a single count
+        Contour = 3 //computed, and the blocks around are queued
+    };
+
+    struct Block
+    {
+        unsigned int x, y; //in blocks, relative to the tile
+    };
+
+    class Tracer
+    {
+        public:
+            Tracer (TileContext const& context, Tile const& tile):
+                        _context(context),
+                        _tile(tile),
+                        _width((tile.width + blockSize - 1) / blockSize),
+                        _height((tile.height + blockSize - 1) / blockSize)
+            {
+                _context.flags.assign(static_cast<std::size_t>(_width) * _height, Unknown);
+                _queue.clear();
+            }
+
+            void run()
+            {
+                for (unsigned int x = 0; x < _width; ++x) {
+                    enqueue(x, 0);
+                    enqueue(x, _height - 1);
+                }
+                for (unsigned int y = 0; y < _height; ++y) {
+                    enqueue(0, y);
+                    enqueue(_width - 1, y);
+                }
+
+                do {
+                    computeQueue();
+                } while (queueDisagreements());
+
+                fill();
+            }
+
+        private:
+            std::uint8_t& flag (unsigned int x, unsigned int y)
+            {
+                return _context.flags[y * _width + x];
+            }
+
+            bool isInTile (unsigned int x, unsigned int y) const
+            {
+                return x < _width && y < _height; //wraps around below the tile
+            }
+
+            /* Pixel rectangle of a block, clipped to the tile */
+            Tile getRectangle (unsigned int x, unsigned int y) const
+            {
+                Tile rectangle;
+                rectangle.x = _tile.x + x * blockSize;
+                rectangle.y = _tile.y + y * blockSize;
+                rectangle.width = std::min(blockSize, _tile.x + _tile.width - rectangle.x);
+                rectangle.height = std::min(blockSize, _tile.y + _tile.height - rectangle.y);
+                return rectangle;
+            }
+
+            /* Count of a block that was computed with a single count or filled */
+            unsigned int getValue (unsigned int x, unsigned int y) const
+            {
+                return _context.buffer.at(_tile.x + x * blockSize, _tile.y + y * blockSize);
+            }
+
+            void enqueue (unsigned int x, unsigned int y)
+            {
+                std::uint8_t& f = flag(x, y);
+                if (f == Unknown) {
+                    f = Queued;
+                    _queue.push_back(Block{x, y});
+                }
+            }
+
+            void markContour (unsigned int x, unsigned int y)
+            {
+                std::uint8_t& f = flag(x, y);
+                if (f == Contour)
+                    return;
+
+                f = Contour;
+                for (unsigned int ny = y - 1; ny != y + 2; ++ny) {
+                    for (unsigned int nx = x - 1; nx != x + 2; ++nx) {
+                        if (isInTile(nx, ny))
+                            enqueue(nx, ny);
+                    }
+                }
+            }
+
+            bool isUniform (Tile const& rectangle) const
+            {
+                IterationBuffer const& buffer = _context.buffer;
+                unsigned int value = buffer.at(rectangle.x, rectangle.y);
+
+                for (unsigned int y = rectangle.y; y < rectangle.y + rectangle.height; ++y) {
+                    for (unsigned int x = rectangle.x; x < rectangle.x + rectangle.width; ++x) {
+                        if (buffer.at(x, y) != value)
+                            return false;
+                    }
+                }
+                return true;
+            }
+
+            /* Computes the queue wave after wave, until no new contour block shows up */
+            void computeQueue()
+            {
+                static const int offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+                while (!_queue.empty()) {
+                    std::vector<Pixel>& pixels = _context.pixels;
+                    pixels.clear();
+                    for (Block const& block : _queue) {
+                        Tile rectangle = getRectangle(block.x, block.y);
+                        for (unsigned int y = rectangle.y; y < rectangle.y + rectangle.height; ++y) {
+                            for (unsigned int x = rectangle.x; x < rectangle.x + rectangle.width; ++x) {
+                                pixels.push_back(Pixel{x, y});
+                            }
+                        }
+                    }
+                    _context.computePixels();
+
+                    _wave.swap(_queue);
+                    _queue.clear();
+
+                    for (Block const& block : _wave) {
+                        flag(block.x, block.y) = Computed;
+                    }
+                    for (Block const& block : _wave) {
+                        if (!isUniform(getRectangle(block.x, block.y))) {
+                            markContour(block.x, block.y);
+                            continue;
+                        }
+
+                        unsigned int value = getValue(block.x, block.y);
+                        for (auto const& offset : offsets) {
+                            unsigned int nx = block.x + offset[0], ny = block.y + offset[1];
+                            if (isInTile(nx, ny) && flag(nx, ny) == Computed && getValue(nx, ny) != value) {
+                                markContour(block.x, block.y);
+                                markContour(nx, ny);
+                            }
+                        }
+                    }
+                }
+            }
+
+            /* Queues the unknown blocks touching computed blocks of different counts,
+             * which happens where a contour only goes diagonally. Returns false if there is none. */
+            bool queueDisagreements()
+            {
+                for (unsigned int y = 1; y + 1 < _height; ++y) {
+                    for (unsigned int x = 1; x + 1 < _width; ++x) {
+                        if (flag(x, y) != Unknown)
+                            continue;
+
+                        bool found = false;
+                        unsigned int value = 0;
+                        for (unsigned int ny = y - 1; ny <= y + 1; ++ny) {
+                            for (unsigned int nx = x - 1; nx <= x + 1; ++nx) {
+                                if (flag(nx, ny) != Computed)
+                                    continue; //contour blocks have no unknown neighbour
+
+                                if (!found) {
+                                    found = true;
+                                    value = getValue(nx, ny);
+                                } else if (getValue(nx, ny) != value) {
+                                    enqueue(x, y);
+                                }
+                            }
+                        }
+                    }
+                }
+
+                return !_queue.empty();
+            }
+
+            /* Each unknown area is now enclosed by blocks of a single count. The edge of the tile
+             * is computed, so the left neighbour of an unknown block is either part of its enclosure,
+             * or of the same area and already filled. */
+            void fill()
+            {
+                IterationBuffer& buffer = _context.buffer;
+
+                for (unsigned int y = 1; y + 1 < _height; ++y) {
+                    for (unsigned int x = 1; x + 1 < _width; ++x) {
+                        if (flag(x, y) != Unknown)
+                            continue;
+
+                        unsigned int value = getValue(x - 1, y);
+                        Tile rectangle = getRectangle(x, y);
+                        for (unsigned int py = rectangle.y; py < rectangle.y + rectangle.height; ++py) {
+                            for (unsigned int px = rectangle.x; px < rectangle.x + rectangle.width; ++px) {
+                                buffer.at(px, py) = value;
+                            }
+                        }
+                    }
+                }
+            }
+
+        private:
+            TileContext const& _context;
+            Tile const& _tile;
+            unsigned int _width, _height; //in blocks
+
+            std::vector<Block> _queue;
+            std::vector<Block> _wave;
+    };
+}
+
+void renderBoundaryTrace (TileContext const& context, Tile const& tile)
+{
+    Tracer tracer(context, tile);
+    tracer.run();
+}
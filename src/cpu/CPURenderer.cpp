@@ -0,0 +1,278 @@
+#include "cpu/CPURenderer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "cpu/BoundaryTrace.hpp"
+#include "cpu/DistanceCulling.hpp"
+#include "cpu/IntervalClassifier.hpp"
+#include "cpu/MarianiSilver.hpp"
+#include "cpu/SolidGuessing.hpp"
+#include "cpu/Symmetry.hpp"
+
+
+namespace
+{
+    /* Rectangles are not split for the interval classifier below this size */
+    const unsigned int minClassifiedSize = 16;
+}
+
+char const* getRenderModeName (RenderMode mode)
+{
+    switch (mode) {
+        case RenderMode::BruteForce:
+            return "brute-force";
+        case RenderMode::MarianiSilver:
+            return "mariani-silver";
+        case RenderMode::BoundaryTrace:
+            return "boundary-trace";
+        case RenderMode::SolidGuessing:
+            return "solid-guessing";
+        case RenderMode::DistanceCulling:
+            return "distance-culling";
+    }
+
+    return "unknown";
+}
+
+CPURenderer::CPURenderer (EscapeTimeKernel const& kernel, unsigned int threadCount):
+            _kernel(&kernel),
+            _tileSize(64),
+            _mode(RenderMode::BruteForce),
+            _culled(nullptr)
+{
+    setThreadCount(threadCount);
+}
+
+void CPURenderer::setKernel (EscapeTimeKernel const& kernel)
+{
+    _kernel = &kernel;
+}
+
+EscapeTimeKernel const& CPURenderer::getKernel() const
+{
+    return *_kernel;
+}
+
+void CPURenderer::setThreadCount (unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = ThreadPool::getHardwareThreadCount();
+
+    if (!_pool || _pool->getWorkerCount() != threadCount) {
+        _pool.reset(); //joins the previous threads first
+        _pool.reset(new ThreadPool(threadCount));
+    }
+    _workers.resize(threadCount);
+}
+
+unsigned int CPURenderer::getThreadCount() const
+{
+    return _pool->getWorkerCount();
+}
+
+void CPURenderer::setTileSize (unsigned int tileSize)
+{
+    if (tileSize == 0)
+        throw std::runtime_error("CPURenderer: tile size must be positive");
+
+    _tileSize = tileSize;
+}
+
+unsigned int CPURenderer::getTileSize() const
+{
+    return _tileSize;
+}
+
+void CPURenderer::setRenderMode (RenderMode mode)
+{
+    _mode = mode;
+}
+
+RenderMode CPURenderer::getRenderMode() const
+{
+    return _mode;
+}
+
+void CPURenderer::setCulledPixels (IterationBuffer* culled)
+{
+    _culled = culled;
+}
+
+void CPURenderer::doRender (RenderParameters const& parameters, std::vector<Tile> const& areas,
+                            IterationBuffer& buffer, RenderStats& stats)
+{
+    if (parameters.step == 0 || parameters.knownStep % parameters.step != 0)
+        throw std::runtime_error("CPURenderer: the known step must be a multiple of the step");
+
+    const bool coarse = (parameters.step > 1);
+    const bool wholeFrame = (areas.size() == 1 && areas[0].x == 0 && areas[0].y == 0 &&
+                             areas[0].width == buffer.getWidth() && areas[0].height == buffer.getHeight());
+    if (coarse && !wholeFrame)
+        throw std::runtime_error("CPURenderer: progressive passes render the whole frame");
+
+    /* Mirrors don't map the grid of a coarse pass onto itself: a coarse pass copies the mirror image
+     * of its blocks, and the pixels of its grid in the mirrored part are not exact. They don't need to be:
+     * the next passes copy that part again, and only rely on the known pixels of the other part.
+     */
+    PixelMapping mapping(parameters, buffer.getWidth(), buffer.getHeight());
+    Symmetry symmetry;
+    bool mirrored = wholeFrame && parameters.symmetryCheck &&
+                    findSymmetry(parameters, mapping, buffer.getWidth(), buffer.getHeight(), symmetry);
+
+    /* Coarse tiles start on the grid, so that every block lies in the tile of its sample.
+     * The mirrored part is the top of the frame, so that the tiles below it do too.
+     */
+    unsigned int tileSize = (_tileSize + parameters.step - 1) / parameters.step * parameters.step;
+    std::vector<Tile> tiles;
+    if (mirrored) {
+        tiles = splitInTiles(buffer.getWidth(), buffer.getHeight(), symmetry.mirrored, tileSize);
+    } else if (coarse) {
+        tiles = splitInTiles(buffer.getWidth(), buffer.getHeight(), tileSize);
+    } else {
+        tiles = splitInTiles(areas, _tileSize);
+    }
+
+    if (_culled) {
+        if (_culled->getWidth() != buffer.getWidth() || _culled->getHeight() != buffer.getHeight())
+            throw std::runtime_error("CPURenderer: the culled pixels must have the size of the buffer");
+
+        for (Tile const& area : areas) {
+            for (unsigned int y = area.y; y < area.y + area.height; ++y) {
+                for (unsigned int x = area.x; x < area.x + area.width; ++x) {
+                    _culled->at(x, y) = 0;
+                }
+            }
+        }
+    }
+
+    for (Worker& worker : _workers) {
+        worker.stats = RenderStats();
+    }
+
+    _pool->run(tiles.size(), [&](std::size_t task, unsigned int index) {
+        Worker& worker = _workers[index];
+        TileContext context = {*_kernel, parameters, mapping, buffer, worker.stats,
+                               worker.pixels, worker.flags, worker.estimates, _culled};
+        renderTile(context, tiles[task]);
+    });
+
+    for (Worker const& worker : _workers) {
+        stats.merge(worker.stats);
+    }
+
+    if (mirrored) {
+        copyMirrored(symmetry, buffer);
+        if (_culled)
+            copyMirrored(symmetry, *_culled);
+        stats.mirroredPixels += static_cast<std::uint64_t>(symmetry.mirrored.width) * symmetry.mirrored.height;
+    }
+}
+
+void CPURenderer::doResume (RenderParameters const& parameters, PixelMapping const& mapping,
+                            Orbit* orbits, std::size_t count, RenderStats& stats)
+{
+    /* Tile-sized batches, so that the workers share them evenly */
+    const std::size_t batchSize = static_cast<std::size_t>(_tileSize) * _tileSize;
+    const std::size_t batches = (count + batchSize - 1) / batchSize;
+
+    for (Worker& worker : _workers) {
+        worker.stats = RenderStats();
+    }
+
+    _pool->run(batches, [&](std::size_t task, unsigned int index) {
+        RenderStats& workerStats = _workers[index].stats;
+        std::size_t first = task * batchSize;
+        std::size_t size = std::min(batchSize, count - first);
+        _kernel->resume(parameters, mapping, orbits + first, size, workerStats);
+        workerStats.computedPixels += size;
+    });
+
+    for (Worker const& worker : _workers) {
+        stats.merge(worker.stats);
+    }
+}
+
+void CPURenderer::renderCoarseRectangle (TileContext const& context, Tile const& rectangle) const
+{
+    const unsigned int step = context.parameters.step;
+    context.pixels.clear();
+    for (unsigned int y = rectangle.y; y < rectangle.y + rectangle.height; y += step) {
+        for (unsigned int x = rectangle.x; x < rectangle.x + rectangle.width; x += step) {
+            context.pixels.push_back(Pixel{x, y});
+        }
+    }
+    context.computePixels();
+
+    IterationBuffer& buffer = context.buffer;
+    for (unsigned int y = rectangle.y; y < rectangle.y + rectangle.height; ++y) {
+        for (unsigned int x = rectangle.x; x < rectangle.x + rectangle.width; ++x) {
+            buffer.at(x, y) = buffer.at(x - x % step, y - y % step);
+        }
+    }
+}
+
+bool CPURenderer::fillIfUniform (TileContext const& context, Tile const& tile) const
+{
+    unsigned int iterations;
+    if (!classifyRectangle(context.parameters, context.mapping, tile, iterations))
+        return false;
+
+    for (unsigned int y = tile.y; y < tile.y + tile.height; ++y) {
+        for (unsigned int x = tile.x; x < tile.x + tile.width; ++x) {
+            context.buffer.at(x, y) = iterations;
+        }
+    }
+    context.stats.classifiedPixels += static_cast<std::uint64_t>(tile.width) * tile.height;
+    return true;
+}
+
+void CPURenderer::renderTile (TileContext const& context, Tile const& tile) const
+{
+    const bool classify = context.parameters.intervalCheck;
+    if (classify && fillIfUniform(context, tile))
+        return;
+
+    /* Quadrants of coarse passes start on their grid too */
+    const unsigned int step = context.parameters.step;
+    unsigned int halfWidth = tile.width / 2 / step * step, halfHeight = tile.height / 2 / step * step;
+
+    if (!classify || halfWidth < minClassifiedSize || halfHeight < minClassifiedSize) {
+        if (step > 1)
+            renderCoarseRectangle(context, tile);
+        else
+            renderRectangle(context, tile);
+        return;
+    }
+
+    Tile quadrants[4] = {
+        {tile.x, tile.y, halfWidth, halfHeight},
+        {tile.x + halfWidth, tile.y, tile.width - halfWidth, halfHeight},
+        {tile.x, tile.y + halfHeight, halfWidth, tile.height - halfHeight},
+        {tile.x + halfWidth, tile.y + halfHeight, tile.width - halfWidth, tile.height - halfHeight}
+    };
+    for (Tile const& quadrant : quadrants) {
+        renderTile(context, quadrant);
+    }
+}
+
+void CPURenderer::renderRectangle (TileContext const& context, Tile const& rectangle) const
+{
+    switch (_mode) {
+        case RenderMode::BruteForce:
+            context.computeRectangle(rectangle);
+            break;
+        case RenderMode::MarianiSilver:
+            renderMarianiSilver(context, rectangle);
+            break;
+        case RenderMode::BoundaryTrace:
+            renderBoundaryTrace(context, rectangle);
+            break;
+        case RenderMode::SolidGuessing:
+            renderSolidGuessing(context, rectangle);
+            break;
+        case RenderMode::DistanceCulling:
+            renderDistanceCulling(context, rectangle);
+            break;
+    }
+}
@@ -0,0 +1,245 @@
+#include "cpu/DistanceCulling.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+    /* Sampling steps, the last pass computes every remaining pixel with the plain kernel */
+    const unsigned int steps[] = {16, 8, 4};
+
+    /* Samples are iterated by the scalar code that carries the derivative: the deep ones, whose disks
+     * would be small anyway, are given up after a few times the count of the shallowest sample
+     * and left to the vectorized kernel
+     */
+    unsigned int getSamplingLimit (unsigned int shallowest, unsigned int maxIter)
+    {
+        return std::min(2 * shallowest + 32, maxIter);
+    }
+
+    /* Share of the distance bound that is filled, see the Harnack bound in DistanceCulling.hpp */
+    const double cullFactor = 0.25;
+
+    /* Largest change of the smooth count within the filled disk: log2((1 + f) / (1 - f)) */
+    const double harnackBound = std::log2((1.0 + cullFactor) / (1.0 - cullFactor));
+
+    enum : std::uint8_t
+    {
+        Unknown = 0,
+        Computed = 1,
+        Culled = 2,
+        Known = 3 //computed by a previous pass, see RenderParameters::knownStep
+    };
+
+    /* For the smooth count s of a pixel that escaped at iteration n, s - log2(ln 2) lies in [n-1, n[ */
+    double toBand (double smoothIter)
+    {
+        return smoothIter - std::log2(std::log(2.0));
+    }
+
+    /* The critical orbit of a connected Julia set stays bounded */
+    bool isJuliaConnected (RenderParameters const& parameters)
+    {
+        double cx = parameters.seed.x, cy = parameters.seed.y;
+        double zx = 0.0, zy = 0.0;
+        for (unsigned int i = 0; i < parameters.maxIter; ++i) {
+            double x2 = zx * zx, y2 = zy * zy;
+            if (x2 + y2 > 4.0)
+                return false;
+
+            zy = 2.0 * zx * zy + cy;
+            zx = x2 - y2 + cx;
+        }
+        return true;
+    }
+
+    class Culler
+    {
+        public:
+            Culler (TileContext const& context, Tile const& tile):
+                        _context(context),
+                        _tile(tile),
+                        _sampling(context.parameters),
+                        _shallowest(context.parameters.maxIter / 4),
+                        _stepX(context.mapping.getStepX()),
+                        _stepY(context.mapping.getStepY()),
+                        _xx(glm::dot(_stepX, _stepX)),
+                        _xy(glm::dot(_stepX, _stepY)),
+                        _yy(glm::dot(_stepY, _stepY))
+            {
+                _context.flags.assign(static_cast<std::size_t>(tile.width) * tile.height, Unknown);
+                _unknownInRow.assign(tile.height, tile.width);
+
+                /* Known pixels are neither recomputed nor culled. They have no distance estimate,
+                 * so the samples are taken on columns off their grid: x % knownStep == 1
+                 */
+                const unsigned int known = context.parameters.knownStep;
+                _sampleOffset = 0;
+                if (known != 0) {
+                    const unsigned int firstX = (tile.x + known - 1) / known * known;
+                    const unsigned int firstY = (tile.y + known - 1) / known * known;
+                    for (unsigned int y = firstY; y < tile.y + tile.height; y += known) {
+                        for (unsigned int x = firstX; x < tile.x + tile.width; x += known) {
+                            flag(x, y) = Known;
+                            --_unknownInRow[y - tile.y];
+                        }
+                    }
+                    if (known > 1)
+                        _sampleOffset = (known + 1 - tile.x % known) % known;
+                }
+            }
+
+            void run()
+            {
+                for (unsigned int step : steps) {
+                    enqueue(step, _sampleOffset);
+                    if (!_context.pixels.empty())
+                        computeSamples();
+                }
+
+                enqueue(1, 0);
+                if (!_context.pixels.empty())
+                    _context.computePixels();
+            }
+
+        private:
+            std::uint8_t& flag (unsigned int x, unsigned int y)
+            {
+                return _context.flags[(y - _tile.y) * _tile.width + (x - _tile.x)];
+            }
+
+            /* Queues the unknown pixels of the grid of the given step, shifted by offset columns */
+            void enqueue (unsigned int step, unsigned int offset)
+            {
+                _context.pixels.clear();
+                for (unsigned int y = _tile.y; y < _tile.y + _tile.height; y += step) {
+                    unsigned int& unknown = _unknownInRow[y - _tile.y];
+                    for (unsigned int x = _tile.x + offset; x < _tile.x + _tile.width && unknown > 0; x += step) {
+                        std::uint8_t& f = flag(x, y);
+                        if (f == Unknown) {
+                            f = Computed;
+                            --unknown;
+                            _context.pixels.push_back(Pixel{x, y});
+                        }
+                    }
+                }
+            }
+
+            void computeSamples()
+            {
+                std::vector<Pixel> const& pixels = _context.pixels;
+                std::vector<DistanceEstimate>& estimates = _context.estimates;
+                IterationBuffer const& buffer = _context.buffer;
+
+                const unsigned int maxIter = _context.parameters.maxIter;
+                _sampling.maxIter = getSamplingLimit(_shallowest, maxIter);
+
+                RenderStats stats;
+                estimates.resize(pixels.size());
+                _context.kernel.computeDistances(_sampling, _context.mapping, pixels.data(), pixels.size(),
+                                                 _context.buffer, estimates.data(), stats);
+                if (_sampling.maxIter == maxIter) {
+                    _context.stats.merge(stats);
+                    _context.stats.computedPixels += pixels.size();
+                } else {
+                    _context.stats.iterations += stats.iterations; //the others are given up, so didn't escape
+                }
+
+                for (std::size_t i = 0; i < pixels.size(); ++i) {
+                    unsigned int iter = buffer.at(pixels[i].x, pixels[i].y);
+                    if (_sampling.maxIter < maxIter) {
+                        if (iter >= _sampling.maxIter) {
+                            flag(pixels[i].x, pixels[i].y) = Unknown;
+                            ++_unknownInRow[pixels[i].y - _tile.y];
+                            continue;
+                        }
+                        ++_context.stats.computedPixels;
+                    }
+
+                    if (iter < maxIter)
+                        _shallowest = std::min(_shallowest, iter);
+                    cull(pixels[i], estimates[i]);
+                }
+            }
+
+            /* Fills the unknown pixels of the tile within the disk of the sample */
+            void cull (Pixel const& sample, DistanceEstimate const& estimate)
+            {
+                const double radius = cullFactor * estimate.distance;
+                const double radiusInPixels = radius / _context.mapping.getPixelSize();
+                if (radiusInPixels < 1.0)
+                    return;
+
+                IterationBuffer& buffer = _context.buffer;
+                const int iter = static_cast<int>(buffer.at(sample.x, sample.y));
+                const double band = toBand(estimate.smoothIter);
+                const double phase = band - std::floor(band); //in [0,1[, so that phase + change lies in ]-1,2[
+                const int maxCount = static_cast<int>(_context.parameters.maxIter) - 1;
+
+                /* Changes of the smooth count per pixel step */
+                const double changeX = glm::dot(estimate.gradient, _stepX);
+                const double changeY = glm::dot(estimate.gradient, _stepY);
+
+                const int sx = static_cast<int>(sample.x), sy = static_cast<int>(sample.y);
+                const int reach = static_cast<int>(radiusInPixels);
+                const int x0 = std::max(static_cast<int>(_tile.x), sx - reach);
+                const int x1 = std::min(static_cast<int>(_tile.x + _tile.width) - 1, sx + reach);
+                const int y0 = std::max(static_cast<int>(_tile.y), sy - reach);
+                const int y1 = std::min(static_cast<int>(_tile.y + _tile.height) - 1, sy + reach);
+
+                std::uint64_t culled = 0;
+                for (int y = y0; y <= y1; ++y) {
+                    unsigned int& unknown = _unknownInRow[y - _tile.y];
+                    if (unknown == 0)
+                        continue;
+
+                    const double j = static_cast<double>(y - sy);
+                    for (int x = x0; x <= x1; ++x) {
+                        std::uint8_t& f = flag(x, y);
+                        if (f != Unknown)
+                            continue;
+
+                        const double i = static_cast<double>(x - sx);
+                        if (_xx * i * i + 2.0 * _xy * i * j + _yy * j * j > radius * radius)
+                            continue;
+
+                        double change = std::min(std::max(changeX * i + changeY * j, -harnackBound), harnackBound);
+                        int shift = static_cast<int>(phase + change + 1.0) - 1; //floor(phase + change)
+                        buffer.at(x, y) = static_cast<unsigned int>(std::min(std::max(iter + shift, 0), maxCount));
+                        f = Culled;
+                        if (_context.culled)
+                            _context.culled->at(x, y) = 1;
+                        --unknown;
+                        ++culled;
+                    }
+                }
+                _context.stats.culledPixels += culled;
+            }
+
+        private:
+            TileContext const& _context;
+            Tile const& _tile;
+
+            RenderParameters _sampling; //maxIter lowered to the sampling limit
+            unsigned int _shallowest; //smallest count of the samples that escaped
+            unsigned int _sampleOffset; //first column of the sampling grids, relative to the tile
+
+            std::vector<unsigned int> _unknownInRow; //pixels neither computed nor culled yet
+
+            /* World offsets of a pixel step, and their dot products */
+            glm::dvec2 _stepX, _stepY;
+            double _xx, _xy, _yy;
+    };
+}
+
+void renderDistanceCulling (TileContext const& context, Tile const& tile)
+{
+    if (context.parameters.type == FractalType::Julia && !isJuliaConnected(context.parameters)) {
+        context.computeRectangle(tile);
+        return;
+    }
+
+    Culler culler(context, tile);
+    culler.run();
+}
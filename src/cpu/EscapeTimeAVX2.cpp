@@ -0,0 +1,104 @@
+/* AVX2 lanes: 8 floats, 4 doubles or 4 double-doubles. Compiled with -mavx2 -mfma, only called when the CPU supports it. */
+
+#include <immintrin.h>
+
+#include <cstdint>
+
+#include "cpu/EscapeTimeSIMD.hpp"
+
+
+namespace
+{
+
+struct AVX2Float
+{
+    typedef float Real;
+    typedef __m256 Vec;
+    typedef __m256 Mask;
+    typedef __m256i Counter; //8 x int32
+    static const std::size_t Width = 8;
+
+    static Vec load (float const* p) { return _mm256_load_ps(p); }
+    static void storeReal (Vec v, float* p) { _mm256_store_ps(p, v); }
+    static Vec set1 (float v) { return _mm256_set1_ps(v); }
+    static Vec add (Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static Vec sub (Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    static Vec mul (Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+
+    static Mask lessEqual (Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static Mask maskAnd (Mask a, Mask b) { return _mm256_and_ps(a, b); }
+    static Mask maskOr (Mask a, Mask b) { return _mm256_or_ps(a, b); }
+    /* a and not b */
+    static Mask maskAndNot (Mask a, Mask b) { return _mm256_andnot_ps(b, a); }
+    static bool any (Mask m) { return _mm256_movemask_ps(m) != 0; }
+    static unsigned int bits (Mask m) { return _mm256_movemask_ps(m); }
+    static Mask allLanes() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+    static Mask noLanes() { return _mm256_setzero_ps(); }
+
+    static Counter zeroCounter() { return _mm256_setzero_si256(); }
+    /* Active lanes are all ones, i.e. -1 */
+    static Counter increment (Counter c, Mask m) { return _mm256_sub_epi32(c, _mm256_castps_si256(m)); }
+    static Counter incrementBy (Counter c, Mask m, unsigned int n) { return _mm256_add_epi32(c, _mm256_and_si256(_mm256_castps_si256(m), _mm256_set1_epi32(n))); }
+    static void store (Counter c, unsigned int* out) { _mm256_store_si256(reinterpret_cast<__m256i*>(out), c); }
+};
+
+struct AVX2Double
+{
+    typedef double Real;
+    typedef __m256d Vec;
+    typedef __m256d Mask;
+    typedef __m256i Counter; //4 x int64
+    static const std::size_t Width = 4;
+
+    static Vec load (double const* p) { return _mm256_load_pd(p); }
+    static void storeReal (Vec v, double* p) { _mm256_store_pd(p, v); }
+    static Vec set1 (double v) { return _mm256_set1_pd(v); }
+    static Vec add (Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static Vec sub (Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+    static Vec mul (Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+    /* a * b - p, exact when p is the rounded a * b */
+    static Vec productError (Vec a, Vec b, Vec p) { return _mm256_fmsub_pd(a, b, p); }
+
+    static Mask lessEqual (Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static Mask maskAnd (Mask a, Mask b) { return _mm256_and_pd(a, b); }
+    static Mask maskOr (Mask a, Mask b) { return _mm256_or_pd(a, b); }
+    /* a and not b */
+    static Mask maskAndNot (Mask a, Mask b) { return _mm256_andnot_pd(b, a); }
+    static bool any (Mask m) { return _mm256_movemask_pd(m) != 0; }
+    static unsigned int bits (Mask m) { return _mm256_movemask_pd(m); }
+    static Mask allLanes() { return _mm256_castsi256_pd(_mm256_set1_epi32(-1)); }
+    static Mask noLanes() { return _mm256_setzero_pd(); }
+
+    static Counter zeroCounter() { return _mm256_setzero_si256(); }
+    static Counter increment (Counter c, Mask m) { return _mm256_sub_epi64(c, _mm256_castpd_si256(m)); }
+    static Counter incrementBy (Counter c, Mask m, unsigned int n) { return _mm256_add_epi64(c, _mm256_and_si256(_mm256_castpd_si256(m), _mm256_set1_epi64x(n))); }
+    static void store (Counter c, unsigned int* out)
+    {
+        alignas(32) std::int64_t counts[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(counts), c);
+        for (unsigned int i = 0; i < 4; ++i) {
+            out[i] = counts[i];
+        }
+    }
+};
+
+}
+
+#include "cpu/DoubleDoubleLanes.hpp"
+#include "cpu/EscapeTimeSIMDImpl.hpp"
+
+
+void escapeTimeAVX2 (SIMDInput<float> const& input, unsigned int* iterations, bool* periodic)
+{
+    escapeTimeSIMD<AVX2Float>(input, iterations, periodic);
+}
+
+void escapeTimeAVX2 (SIMDInput<double> const& input, unsigned int* iterations, bool* periodic)
+{
+    escapeTimeSIMD<AVX2Double>(input, iterations, periodic);
+}
+
+void escapeTimeAVX2 (SIMDInput<DoubleDouble> const& input, unsigned int* iterations, bool* periodic)
+{
+    escapeTimeSIMD<DoubleDoubleLanes<AVX2Double>>(input, iterations, periodic);
+}
@@ -0,0 +1,105 @@
+/* AVX-512 lanes: 16 floats, 8 doubles or 8 double-doubles, with mask registers.
+ * Compiled with -mavx512f, only called when the CPU supports it.
+ */
+
+#include <immintrin.h>
+
+#include <cstdint>
+
+#include "cpu/EscapeTimeSIMD.hpp"
+
+
+namespace
+{
+
+struct AVX512Float
+{
+    typedef float Real;
+    typedef __m512 Vec;
+    typedef __mmask16 Mask;
+    typedef __m512i Counter; //16 x int32
+    static const std::size_t Width = 16;
+
+    static Vec load (float const* p) { return _mm512_load_ps(p); }
+    static void storeReal (Vec v, float* p) { _mm512_store_ps(p, v); }
+    static Vec set1 (float v) { return _mm512_set1_ps(v); }
+    static Vec add (Vec a, Vec b) { return _mm512_add_ps(a, b); }
+    static Vec sub (Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+    static Vec mul (Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+
+    static Mask lessEqual (Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static Mask maskAnd (Mask a, Mask b) { return a & b; }
+    static Mask maskOr (Mask a, Mask b) { return a | b; }
+    /* a and not b */
+    static Mask maskAndNot (Mask a, Mask b) { return a & ~b; }
+    static bool any (Mask m) { return m != 0; }
+    static unsigned int bits (Mask m) { return m; }
+    static Mask allLanes() { return 0xFFFF; }
+    static Mask noLanes() { return 0; }
+
+    static Counter zeroCounter() { return _mm512_setzero_si512(); }
+    static Counter increment (Counter c, Mask m) { return _mm512_mask_add_epi32(c, m, c, _mm512_set1_epi32(1)); }
+    static Counter incrementBy (Counter c, Mask m, unsigned int n) { return _mm512_mask_add_epi32(c, m, c, _mm512_set1_epi32(n)); }
+    static void store (Counter c, unsigned int* out) { _mm512_store_si512(out, c); }
+};
+
+struct AVX512Double
+{
+    typedef double Real;
+    typedef __m512d Vec;
+    typedef __mmask8 Mask;
+    typedef __m512i Counter; //8 x int64
+    static const std::size_t Width = 8;
+
+    static Vec load (double const* p) { return _mm512_load_pd(p); }
+    static void storeReal (Vec v, double* p) { _mm512_store_pd(p, v); }
+    static Vec set1 (double v) { return _mm512_set1_pd(v); }
+    static Vec add (Vec a, Vec b) { return _mm512_add_pd(a, b); }
+    static Vec sub (Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+    static Vec mul (Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+    /* a * b - p, exact when p is the rounded a * b */
+    static Vec productError (Vec a, Vec b, Vec p) { return _mm512_fmsub_pd(a, b, p); }
+
+    static Mask lessEqual (Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static Mask maskAnd (Mask a, Mask b) { return a & b; }
+    static Mask maskOr (Mask a, Mask b) { return a | b; }
+    /* a and not b */
+    static Mask maskAndNot (Mask a, Mask b) { return a & ~b; }
+    static bool any (Mask m) { return m != 0; }
+    static unsigned int bits (Mask m) { return m; }
+    static Mask allLanes() { return 0xFF; }
+    static Mask noLanes() { return 0; }
+
+    static Counter zeroCounter() { return _mm512_setzero_si512(); }
+    static Counter increment (Counter c, Mask m) { return _mm512_mask_add_epi64(c, m, c, _mm512_set1_epi64(1)); }
+    static Counter incrementBy (Counter c, Mask m, unsigned int n) { return _mm512_mask_add_epi64(c, m, c, _mm512_set1_epi64(n)); }
+    static void store (Counter c, unsigned int* out)
+    {
+        alignas(64) std::int64_t counts[8];
+        _mm512_store_si512(counts, c);
+        for (unsigned int i = 0; i < 8; ++i) {
+            out[i] = counts[i];
+        }
+    }
+};
+
+}
+
+#include "cpu/DoubleDoubleLanes.hpp"
+#include "cpu/EscapeTimeSIMDImpl.hpp"
+
+
+void escapeTimeAVX512 (SIMDInput<float> const& input, unsigned int* iterations, bool* periodic)
+{
+    escapeTimeSIMD<AVX512Float>(input, iterations, periodic);
+}
+
+void escapeTimeAVX512 (SIMDInput<double> const& input, unsigned int* iterations, bool* periodic)
+{
+    escapeTimeSIMD<AVX512Double>(input, iterations, periodic);
+}
+
+void escapeTimeAVX512 (SIMDInput<DoubleDouble> const& input, unsigned int* iterations, bool* periodic)
+{
+    escapeTimeSIMD<DoubleDoubleLanes<AVX512Double>>(input, iterations, periodic);
+}
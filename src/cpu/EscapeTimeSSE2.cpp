@@ -0,0 +1,115 @@
+/* SSE2 lanes: 4 floats, 2 doubles or 2 double-doubles. Part of the x86-64 baseline, no extra compiler flag. */
+
+#include <emmintrin.h>
+
+#include <cstdint>
+
+#include "cpu/EscapeTimeSIMD.hpp"
+
+
+namespace
+{
+
+struct SSE2Float
+{
+    typedef float Real;
+    typedef __m128 Vec;
+    typedef __m128 Mask;
+    typedef __m128i Counter; //4 x int32
+    static const std::size_t Width = 4;
+
+    static Vec load (float const* p) { return _mm_load_ps(p); }
+    static void storeReal (Vec v, float* p) { _mm_store_ps(p, v); }
+    static Vec set1 (float v) { return _mm_set1_ps(v); }
+    static Vec add (Vec a, Vec b) { return _mm_add_ps(a, b); }
+    static Vec sub (Vec a, Vec b) { return _mm_sub_ps(a, b); }
+    static Vec mul (Vec a, Vec b) { return _mm_mul_ps(a, b); }
+
+    static Mask lessEqual (Vec a, Vec b) { return _mm_cmple_ps(a, b); }
+    static Mask maskAnd (Mask a, Mask b) { return _mm_and_ps(a, b); }
+    static Mask maskOr (Mask a, Mask b) { return _mm_or_ps(a, b); }
+    /* a and not b */
+    static Mask maskAndNot (Mask a, Mask b) { return _mm_andnot_ps(b, a); }
+    static bool any (Mask m) { return _mm_movemask_ps(m) != 0; }
+    static unsigned int bits (Mask m) { return _mm_movemask_ps(m); }
+    static Mask allLanes() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+    static Mask noLanes() { return _mm_setzero_ps(); }
+
+    static Counter zeroCounter() { return _mm_setzero_si128(); }
+    /* Active lanes are all ones, i.e. -1 */
+    static Counter increment (Counter c, Mask m) { return _mm_sub_epi32(c, _mm_castps_si128(m)); }
+    static Counter incrementBy (Counter c, Mask m, unsigned int n) { return _mm_add_epi32(c, _mm_and_si128(_mm_castps_si128(m), _mm_set1_epi32(n))); }
+    static void store (Counter c, unsigned int* out) { _mm_store_si128(reinterpret_cast<__m128i*>(out), c); }
+};
+
+struct SSE2Double
+{
+    typedef double Real;
+    typedef __m128d Vec;
+    typedef __m128d Mask;
+    typedef __m128i Counter; //2 x int64
+    static const std::size_t Width = 2;
+
+    static Vec load (double const* p) { return _mm_load_pd(p); }
+    static void storeReal (Vec v, double* p) { _mm_store_pd(p, v); }
+    static Vec set1 (double v) { return _mm_set1_pd(v); }
+    static Vec add (Vec a, Vec b) { return _mm_add_pd(a, b); }
+    static Vec sub (Vec a, Vec b) { return _mm_sub_pd(a, b); }
+    static Vec mul (Vec a, Vec b) { return _mm_mul_pd(a, b); }
+    /* a * b - p, exact when p is the rounded a * b: without a fused multiply-add,
+     * the factors are split in halves whose products are exact (Dekker) */
+    static Vec productError (Vec a, Vec b, Vec p)
+    {
+        const Vec splitter = _mm_set1_pd(134217729.0); //2^27 + 1
+        Vec t = _mm_mul_pd(splitter, a);
+        const Vec aHi = _mm_sub_pd(t, _mm_sub_pd(t, a)), aLo = _mm_sub_pd(a, aHi);
+        t = _mm_mul_pd(splitter, b);
+        const Vec bHi = _mm_sub_pd(t, _mm_sub_pd(t, b)), bLo = _mm_sub_pd(b, bHi);
+        Vec error = _mm_sub_pd(_mm_mul_pd(aHi, bHi), p);
+        error = _mm_add_pd(error, _mm_mul_pd(aHi, bLo));
+        error = _mm_add_pd(error, _mm_mul_pd(aLo, bHi));
+        return _mm_add_pd(error, _mm_mul_pd(aLo, bLo));
+    }
+
+    static Mask lessEqual (Vec a, Vec b) { return _mm_cmple_pd(a, b); }
+    static Mask maskAnd (Mask a, Mask b) { return _mm_and_pd(a, b); }
+    static Mask maskOr (Mask a, Mask b) { return _mm_or_pd(a, b); }
+    /* a and not b */
+    static Mask maskAndNot (Mask a, Mask b) { return _mm_andnot_pd(b, a); }
+    static bool any (Mask m) { return _mm_movemask_pd(m) != 0; }
+    static unsigned int bits (Mask m) { return _mm_movemask_pd(m); }
+    static Mask allLanes() { return _mm_castsi128_pd(_mm_set1_epi32(-1)); }
+    static Mask noLanes() { return _mm_setzero_pd(); }
+
+    static Counter zeroCounter() { return _mm_setzero_si128(); }
+    static Counter increment (Counter c, Mask m) { return _mm_sub_epi64(c, _mm_castpd_si128(m)); }
+    static Counter incrementBy (Counter c, Mask m, unsigned int n) { return _mm_add_epi64(c, _mm_and_si128(_mm_castpd_si128(m), _mm_set1_epi64x(n))); }
+    static void store (Counter c, unsigned int* out)
+    {
+        alignas(16) std::int64_t counts[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(counts), c);
+        out[0] = counts[0];
+        out[1] = counts[1];
+    }
+};
+
+}
+
+#include "cpu/DoubleDoubleLanes.hpp"
+#include "cpu/EscapeTimeSIMDImpl.hpp"
+
+
+void escapeTimeSSE2 (SIMDInput<float> const& input, unsigned int* iterations, bool* periodic)
+{
+    escapeTimeSIMD<SSE2Float>(input, iterations, periodic);
+}
+
+void escapeTimeSSE2 (SIMDInput<double> const& input, unsigned int* iterations, bool* periodic)
+{
+    escapeTimeSIMD<SSE2Double>(input, iterations, periodic);
+}
+
+void escapeTimeSSE2 (SIMDInput<DoubleDouble> const& input, unsigned int* iterations, bool* periodic)
+{
+    escapeTimeSIMD<DoubleDoubleLanes<SSE2Double>>(input, iterations, periodic);
+}
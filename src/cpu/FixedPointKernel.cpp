@@ -0,0 +1,329 @@
+#include "cpu/FixedPointKernel.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+#include "cpu/ScalarKernel.hpp"
+
+
+namespace
+{
+    __extension__ typedef __int128 Fixed; //raw value: the number times 2^120
+    __extension__ typedef unsigned __int128 Magnitude;
+
+    const int fractionBits = 120;
+    const double maxCoordinate = 64.0;
+
+    const Fixed two = Fixed(2) << fractionBits;
+    const Fixed four = Fixed(4) << fractionBits;
+
+    /* Truncates the bits below 2^-120, clamps beyond maxCoordinate */
+    Fixed toFixed (double value)
+    {
+        if (!(value <= maxCoordinate))
+            value = maxCoordinate;
+        else if (value < -maxCoordinate)
+            value = -maxCoordinate;
+        return static_cast<Fixed>(std::ldexp(value, fractionBits));
+    }
+
+    double toDouble (Fixed value)
+    {
+        return std::ldexp(static_cast<double>(value), -fractionBits);
+    }
+
+    Magnitude magnitude (Fixed value)
+    {
+        return (value < 0) ? -static_cast<Magnitude>(value) : static_cast<Magnitude>(value);
+    }
+
+    /* Bits 120 to 247 of the 256-bit product of a and b, from the four products of their 64-bit halves */
+    Magnitude multiplyMagnitudes (Magnitude a, Magnitude b)
+    {
+        const std::uint64_t a0 = static_cast<std::uint64_t>(a), a1 = static_cast<std::uint64_t>(a >> 64);
+        const std::uint64_t b0 = static_cast<std::uint64_t>(b), b1 = static_cast<std::uint64_t>(b >> 64);
+
+        const Magnitude p00 = static_cast<Magnitude>(a0) * b0;
+        const Magnitude p01 = static_cast<Magnitude>(a0) * b1;
+        const Magnitude p10 = static_cast<Magnitude>(a1) * b0;
+        const Magnitude p11 = static_cast<Magnitude>(a1) * b1;
+
+        /* Bits 64 to 191, then 128 to 255 */
+        const Magnitude middle = (p00 >> 64) + static_cast<std::uint64_t>(p01) + static_cast<std::uint64_t>(p10);
+        const Magnitude high = p11 + (p01 >> 64) + (p10 >> 64) + (middle >> 64);
+        return (high << (128 - fractionBits)) | (static_cast<std::uint64_t>(middle) >> (fractionBits - 64));
+    }
+
+    /* Truncated toward zero, so that the result doesn't depend on the signs */
+    Fixed multiply (Fixed a, Fixed b)
+    {
+        const Fixed product = static_cast<Fixed>(multiplyMagnitudes(magnitude(a), magnitude(b)));
+        return ((a < 0) != (b < 0)) ? -product : product;
+    }
+
+    Fixed square (Fixed a)
+    {
+        const Magnitude m = magnitude(a);
+        return static_cast<Fixed>(multiplyMagnitudes(m, m));
+    }
+
+    /* The center of the view plus the offset of the pixel to it, summed exactly.
+     * Far from the origin or at low zoom, where doubles are precise enough, the world position is used instead.
+     */
+    Fixed toFixedPosition (double center, double offset, double world)
+    {
+        if (std::abs(center) <= 0.5 * maxCoordinate && std::abs(offset) <= 0.5 * maxCoordinate)
+            return toFixed(center) + toFixed(offset);
+        return toFixed(world);
+    }
+
+    void toFixedPosition (PixelMapping const& mapping, unsigned int x, unsigned int y, Fixed& posX, Fixed& posY)
+    {
+        glm::dvec2 const& center = mapping.getCenter();
+        const glm::dvec2 offset = mapping.toCenterOffset(x, y);
+        const glm::dvec2 world = mapping.toWorld(x, y);
+        posX = toFixedPosition(center.x, offset.x, world.x);
+        posY = toFixedPosition(center.y, offset.y, world.y);
+    }
+
+    /* z = hi + lo + tail exactly: each double takes the 53 leading bits of what is left */
+    void saveCoordinate (Fixed value, double& hi, double& lo, double& tail)
+    {
+        hi = toDouble(value);
+        value -= toFixed(hi);
+        lo = toDouble(value);
+        value -= toFixed(lo);
+        tail = toDouble(value);
+    }
+
+    Fixed loadCoordinate (double hi, double lo, double tail)
+    {
+        return toFixed(hi) + toFixed(lo) + toFixed(tail);
+    }
+
+    /* Squares of z if |z| <= 2, false if z escaped. Coordinates are compared first, so that squares
+     * stay below 4 and no sum can overflow: z' then stays below 4 + maxCoordinate.
+     */
+    bool squaresIfBounded (Fixed zx, Fixed zy, Fixed& x2, Fixed& y2)
+    {
+        if (magnitude(zx) > static_cast<Magnitude>(two) || magnitude(zy) > static_cast<Magnitude>(two))
+            return false;
+
+        x2 = square(zx);
+        y2 = square(zy);
+        return x2 + y2 <= four;
+    }
+
+    /* Brent's cycle detection, as CycleDetector. Squared distances below 2^-60 vanish in fixed point:
+     * differences within tolerance on both coordinates are converted to doubles, exactly enough,
+     * and tested against the same disk as the other kernels.
+     */
+    class FixedCycleDetector
+    {
+        public:
+            FixedCycleDetector (Fixed zx, Fixed zy, double tolerance):
+                        _refX(zx),
+                        _refY(zy),
+                        _tolerance(static_cast<Magnitude>(toFixed(tolerance))),
+                        _tolerance2(tolerance * tolerance),
+                        _steps(0),
+                        _period(1),
+                        _returned(false),
+                        _periodic(false)
+            {
+            }
+
+            /* z passed the escape test, so the differences can't overflow */
+            bool check (Fixed zx, Fixed zy)
+            {
+                const Fixed dx = zx - _refX, dy = zy - _refY;
+                if (magnitude(dx) <= _tolerance && magnitude(dy) <= _tolerance) {
+                    const double x = toDouble(dx), y = toDouble(dy);
+                    if (x * x + y * y <= _tolerance2) {
+                        if (_returned) {
+                            _periodic = true;
+                            return true;
+                        }
+                        _returned = true;
+                    }
+                }
+
+                if (++_steps == _period) {
+                    _steps = 0;
+                    _period *= 2;
+                    _refX = zx;
+                    _refY = zy;
+                    _returned = false;
+                }
+                return false;
+            }
+
+            bool isPeriodic() const
+            {
+                return _periodic;
+            }
+
+        private:
+            Fixed _refX, _refY;
+            Magnitude _tolerance;
+            double _tolerance2;
+            unsigned int _steps, _period;
+            bool _returned;
+            bool _periodic;
+    };
+
+    /* Same loop as escapeTimePeriodic(). The detector looks at z at the next escape test,
+     * once it is known to be bounded: an escaped z is never near a reference point anyway.
+     * With estimate, also carries the derivative like escapeTimeDistance().
+     */
+    unsigned int iterate (Fixed& zx, Fixed& zy, Fixed cx, Fixed cy, unsigned int maxIter,
+                          FixedCycleDetector* detector, bool julia=false, DistanceEstimate* estimate=nullptr)
+    {
+        const double dc = julia ? 0.0 : 1.0;
+        double dzx = 1.0, dzy = 0.0;
+
+        unsigned int iter = 0;
+        while (iter < maxIter) {
+            Fixed x2, y2;
+            if (!squaresIfBounded(zx, zy, x2, y2)) {
+                if (estimate)
+                    estimateDistance(toDouble(zx), toDouble(zy), toDouble(cx), toDouble(cy), dzx, dzy, iter, julia, *estimate);
+                return iter;
+            }
+            if (iter > 0 && detector && detector->check(zx, zy))
+                break;
+
+            if (estimate) {
+                const double x = toDouble(zx), y = toDouble(zy);
+                const double newDzx = 2.0 * (x * dzx - y * dzy) + dc;
+                dzy = 2.0 * (x * dzy + y * dzx);
+                dzx = newDzx;
+            }
+
+            zy = 2 * multiply(zx, zy) + cy;
+            zx = x2 - y2 + cx;
+
+            ++iter;
+        }
+
+        /* The last z wasn't looked at yet */
+        if (iter == maxIter && detector) {
+            Fixed x2, y2;
+            if (squaresIfBounded(zx, zy, x2, y2))
+                detector->check(zx, zy);
+        }
+
+        if (estimate)
+            *estimate = DistanceEstimate();
+        return iter;
+    }
+
+    struct Settings
+    {
+        Settings (RenderParameters const& parameters, PixelMapping const& mapping):
+            julia(parameters.type == FractalType::Julia),
+            cardioidCheck(!julia && parameters.cardioidCheck),
+            periodicityCheck(parameters.periodicityCheck),
+            seedX(toFixed(parameters.seed.x)),
+            seedY(toFixed(parameters.seed.y)),
+            tolerance(parameters.periodicityTolerance * mapping.getPixelSize())
+        {}
+
+        bool julia;
+        bool cardioidCheck;
+        bool periodicityCheck;
+        Fixed seedX, seedY;
+        double tolerance;
+    };
+
+    void computePixels (RenderParameters const& parameters, PixelMapping const& mapping,
+                        Pixel const* pixels, std::size_t count,
+                        IterationBuffer& buffer, DistanceEstimate* estimates, RenderStats& stats)
+    {
+        const Settings settings(parameters, mapping);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (estimates)
+                estimates[i] = DistanceEstimate();
+
+            if (settings.cardioidCheck && isInCardioidOrBulb(mapping.toWorld(pixels[i].x, pixels[i].y))) {
+                buffer.at(pixels[i].x, pixels[i].y) = parameters.maxIter;
+                ++stats.cardioidSkipped;
+                continue;
+            }
+
+            Fixed x, y;
+            toFixedPosition(mapping, pixels[i].x, pixels[i].y, x, y);
+            const Fixed cx = settings.julia ? settings.seedX : x, cy = settings.julia ? settings.seedY : y;
+
+            FixedCycleDetector detector(x, y, settings.tolerance);
+            unsigned int iter = iterate(x, y, cx, cy, parameters.maxIter,
+                                        settings.periodicityCheck ? &detector : nullptr,
+                                        settings.julia, estimates ? &estimates[i] : nullptr);
+
+            buffer.at(pixels[i].x, pixels[i].y) = detector.isPeriodic() ? parameters.maxIter : iter;
+            stats.iterations += iter;
+            if (detector.isPeriodic())
+                ++stats.periodicExits;
+        }
+    }
+}
+
+char const* FixedPointKernel::getName() const
+{
+    return "scalar-fixed128";
+}
+
+void FixedPointKernel::compute (RenderParameters const& parameters, PixelMapping const& mapping,
+                                Pixel const* pixels, std::size_t count,
+                                IterationBuffer& buffer, RenderStats& stats) const
+{
+    computePixels(parameters, mapping, pixels, count, buffer, nullptr, stats);
+}
+
+void FixedPointKernel::computeDistances (RenderParameters const& parameters, PixelMapping const& mapping,
+                                         Pixel const* pixels, std::size_t count,
+                                         IterationBuffer& buffer, DistanceEstimate* estimates,
+                                         RenderStats& stats) const
+{
+    computePixels(parameters, mapping, pixels, count, buffer, estimates, stats);
+}
+
+void FixedPointKernel::resume (RenderParameters const& parameters, PixelMapping const& mapping,
+                               Orbit* orbits, std::size_t count, RenderStats& stats) const
+{
+    const Settings settings(parameters, mapping);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        Orbit& orbit = orbits[i];
+        if (orbit.interior || orbit.iter >= parameters.maxIter)
+            continue;
+
+        Fixed posX, posY;
+        toFixedPosition(mapping, orbit.pixel.x, orbit.pixel.y, posX, posY);
+        Fixed x = posX, y = posY;
+        if (orbit.iter == 0) {
+            if (settings.cardioidCheck && isInCardioidOrBulb(mapping.toWorld(orbit.pixel.x, orbit.pixel.y))) {
+                orbit.interior = true;
+                ++stats.cardioidSkipped;
+                continue;
+            }
+        } else {
+            x = loadCoordinate(orbit.zx, orbit.zxLo, orbit.zxTail);
+            y = loadCoordinate(orbit.zy, orbit.zyLo, orbit.zyTail);
+        }
+        const Fixed cx = settings.julia ? settings.seedX : posX, cy = settings.julia ? settings.seedY : posY;
+
+        FixedCycleDetector detector(x, y, settings.tolerance);
+        unsigned int iter = iterate(x, y, cx, cy, parameters.maxIter - orbit.iter,
+                                    settings.periodicityCheck ? &detector : nullptr);
+
+        orbit.iter += iter;
+        orbit.interior = detector.isPeriodic();
+        saveCoordinate(x, orbit.zx, orbit.zxLo, orbit.zxTail);
+        saveCoordinate(y, orbit.zy, orbit.zyLo, orbit.zyTail);
+        stats.iterations += iter;
+        if (detector.isPeriodic())
+            ++stats.periodicExits;
+    }
+}
@@ -0,0 +1,54 @@
+#include "cpu/FractalRenderer.hpp"
+
+#include <chrono>
+
+
+void FractalRenderer::render (RenderParameters const& parameters, IterationBuffer& buffer)
+{
+    render(parameters, std::vector<Tile>(1, Tile{0, 0, buffer.getWidth(), buffer.getHeight()}), buffer);
+}
+
+void FractalRenderer::render (RenderParameters const& parameters, std::vector<Tile> const& areas, IterationBuffer& buffer)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    RenderStats stats;
+    for (Tile const& area : areas) {
+        stats.pixels += static_cast<std::uint64_t>(area.width) * area.height;
+    }
+
+    Clock::time_point start = Clock::now();
+    doRender(parameters, areas, buffer, stats);
+    stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    _stats = stats;
+}
+
+void FractalRenderer::resume (RenderParameters const& parameters, OrbitCache& cache, IterationBuffer& buffer)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    RenderStats stats;
+    stats.pixels = static_cast<std::uint64_t>(cache.getWidth()) * cache.getHeight();
+
+    Clock::time_point start = Clock::now();
+    std::size_t count = cache.prepare(parameters.maxIter);
+    PixelMapping mapping(parameters, cache.getWidth(), cache.getHeight());
+    doResume(parameters, mapping, cache.getOrbits(), count, stats);
+    cache.update(parameters.maxIter, buffer);
+    stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    _stats = stats;
+}
+
+void FractalRenderer::render (RenderParameters const& parameters, Palette const& palette,
+                              IterationBuffer& buffer, std::vector<std::uint8_t>& rgba)
+{
+    render(parameters, buffer);
+    palette.colorize(buffer, parameters.maxIter, rgba);
+}
+
+RenderStats const& FractalRenderer::getStats() const
+{
+    return _stats;
+}
@@ -0,0 +1,145 @@
+#include "cpu/IntervalClassifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+    /* Relative widening after each operation: above the float unit roundoff (2^-24),
+     * with enough margin for the double arithmetic the bounds are computed with.
+     * The absolute one is above the spacing of the fixed-point kernel (2^-120), which truncates
+     * near zero too, and of the subnormal floats.
+     */
+    const double relativeError = std::ldexp(1.0, -22);
+    const double absoluteError = std::ldexp(1.0, -118);
+
+    struct Interval
+    {
+        double lo, hi;
+
+        /* Encloses the rounded result of any operation whose exact result is in [lo,hi] */
+        Interval widened() const
+        {
+            Interval result;
+            result.lo = lo - (std::fabs(lo) * relativeError + absoluteError);
+            result.hi = hi + (std::fabs(hi) * relativeError + absoluteError);
+            return result;
+        }
+
+        bool contains (Interval const& other) const
+        {
+            return lo <= other.lo && other.hi <= hi;
+        }
+    };
+
+    Interval makeInterval (double a, double b)
+    {
+        Interval result;
+        result.lo = std::min(a, b);
+        result.hi = std::max(a, b);
+        return result;
+    }
+
+    Interval operator+ (Interval const& a, Interval const& b)
+    {
+        return makeInterval(a.lo + b.lo, a.hi + b.hi).widened();
+    }
+
+    Interval operator- (Interval const& a, Interval const& b)
+    {
+        return makeInterval(a.lo - b.hi, a.hi - b.lo).widened();
+    }
+
+    Interval operator* (Interval const& a, Interval const& b)
+    {
+        double p0 = a.lo * b.lo, p1 = a.lo * b.hi, p2 = a.hi * b.lo, p3 = a.hi * b.hi;
+        Interval result;
+        result.lo = std::min(std::min(p0, p1), std::min(p2, p3));
+        result.hi = std::max(std::max(p0, p1), std::max(p2, p3));
+        return result.widened();
+    }
+
+    Interval square (Interval const& a)
+    {
+        double l2 = a.lo * a.lo, h2 = a.hi * a.hi;
+        Interval result;
+        result.lo = (a.lo <= 0.0 && a.hi >= 0.0) ? 0.0 : std::min(l2, h2);
+        result.hi = std::max(l2, h2);
+        return result.widened();
+    }
+
+    struct Box
+    {
+        Interval x, y;
+
+        bool contains (Box const& other) const
+        {
+            return x.contains(other.x) && y.contains(other.y);
+        }
+    };
+}
+
+bool classifyRectangle (RenderParameters const& parameters, PixelMapping const& mapping,
+                        Tile const& rectangle, unsigned int& iterations)
+{
+    /* toWorld is affine, so the pixel centers lie in the hull of the corner ones */
+    glm::dvec2 corners[4] = {
+        mapping.toWorld(rectangle.x, rectangle.y),
+        mapping.toWorld(rectangle.x + rectangle.width - 1, rectangle.y),
+        mapping.toWorld(rectangle.x, rectangle.y + rectangle.height - 1),
+        mapping.toWorld(rectangle.x + rectangle.width - 1, rectangle.y + rectangle.height - 1)
+    };
+    Box z;
+    z.x = makeInterval(corners[0].x, corners[0].x);
+    z.y = makeInterval(corners[0].y, corners[0].y);
+    for (glm::dvec2 const& corner : corners) {
+        z.x = makeInterval(std::min(z.x.lo, corner.x), std::max(z.x.hi, corner.x));
+        z.y = makeInterval(std::min(z.y.lo, corner.y), std::max(z.y.hi, corner.y));
+    }
+    z.x = z.x.widened(); //conversion of the pixel position to the kernel precision
+    z.y = z.y.widened();
+
+    Box c = z;
+    if (parameters.type == FractalType::Julia) {
+        c.x = makeInterval(parameters.seed.x, parameters.seed.x);
+        c.y = makeInterval(parameters.seed.y, parameters.seed.y);
+    }
+
+    const Interval four = makeInterval(4.0, 4.0);
+    const Interval two = makeInterval(2.0, 2.0);
+
+    /* Brent's schedule, as for the cycle detection of the kernels */
+    Box reference = z;
+    unsigned int steps = 0, period = 1;
+
+    for (unsigned int iter = 0; iter < parameters.maxIter; ++iter) {
+        /* Same operations as escapeTime() */
+        Interval x2 = square(z.x), y2 = square(z.y);
+        Interval r2 = x2 + y2;
+        if (r2.lo > four.hi) {
+            iterations = iter; //all escape now
+            return true;
+        }
+        if (r2.hi > four.lo)
+            return false; //some escape now, not all
+
+        z.y = two * z.x * z.y + c.y;
+        z.x = x2 - y2 + c.x;
+
+        /* The interval map is monotonic for inclusion: from now on the box stays inside
+         * the ones that followed the reference, none of which crossed |z| = 2 */
+        if (reference.contains(z)) {
+            iterations = parameters.maxIter;
+            return true;
+        }
+        if (++steps == period) {
+            steps = 0;
+            period *= 2;
+            reference = z;
+        }
+    }
+
+    iterations = parameters.maxIter;
+    return true;
+}
@@ -0,0 +1,31 @@
+#include "cpu/IterationBuffer.hpp"
+
+
+IterationBuffer::IterationBuffer (unsigned int width, unsigned int height):
+            _width(0),
+            _height(0)
+{
+    resize(width, height);
+}
+
+void IterationBuffer::resize (unsigned int width, unsigned int height)
+{
+    _width = width;
+    _height = height;
+    _iterations.assign(static_cast<std::size_t>(width) * height, 0u);
+}
+
+unsigned int IterationBuffer::getWidth() const
+{
+    return _width;
+}
+
+unsigned int IterationBuffer::getHeight() const
+{
+    return _height;
+}
+
+std::vector<unsigned int> const& IterationBuffer::getData() const
+{
+    return _iterations;
+}
@@ -0,0 +1,106 @@
+#include "cpu/MarianiSilver.hpp"
+
+
+namespace
+{
+    /* Rectangles whose interior is that thin or thinner are computed as they are:
+     * subdividing them further would cost more border evaluations than it can save. */
+    const unsigned int minInteriorSize = 4;
+
+    /* Bounds are inclusive, and the border pixels are already computed */
+    struct Rectangle
+    {
+        unsigned int x0, y0;
+        unsigned int x1, y1;
+    };
+
+    bool isBorderUniform (IterationBuffer const& buffer, Rectangle const& rectangle, unsigned int& value)
+    {
+        value = buffer.at(rectangle.x0, rectangle.y0);
+
+        for (unsigned int x = rectangle.x0; x <= rectangle.x1; ++x) {
+            if (buffer.at(x, rectangle.y0) != value || buffer.at(x, rectangle.y1) != value)
+                return false;
+        }
+        for (unsigned int y = rectangle.y0 + 1; y < rectangle.y1; ++y) {
+            if (buffer.at(rectangle.x0, y) != value || buffer.at(rectangle.x1, y) != value)
+                return false;
+        }
+
+        return true;
+    }
+
+    void subdivide (TileContext const& context, Rectangle const& rectangle)
+    {
+        if (rectangle.x1 - rectangle.x0 < 2 || rectangle.y1 - rectangle.y0 < 2)
+            return; //no interior
+
+        Tile interior;
+        interior.x = rectangle.x0 + 1;
+        interior.y = rectangle.y0 + 1;
+        interior.width = rectangle.x1 - rectangle.x0 - 1;
+        interior.height = rectangle.y1 - rectangle.y0 - 1;
+
+        unsigned int value;
+        if (isBorderUniform(context.buffer, rectangle, value)) {
+            for (unsigned int y = interior.y; y < interior.y + interior.height; ++y) {
+                for (unsigned int x = interior.x; x < interior.x + interior.width; ++x) {
+                    context.buffer.at(x, y) = value;
+                }
+            }
+            return;
+        }
+
+        if (interior.width <= minInteriorSize || interior.height <= minInteriorSize) {
+            context.computeRectangle(interior);
+            return;
+        }
+
+        /* Splits across the longest side */
+        Rectangle first = rectangle, second = rectangle;
+        Tile median = interior;
+        if (interior.width >= interior.height) {
+            median.x = rectangle.x0 + (rectangle.x1 - rectangle.x0) / 2;
+            median.width = 1;
+            first.x1 = median.x;
+            second.x0 = median.x;
+        } else {
+            median.y = rectangle.y0 + (rectangle.y1 - rectangle.y0) / 2;
+            median.height = 1;
+            first.y1 = median.y;
+            second.y0 = median.y;
+        }
+
+        context.computeRectangle(median);
+        subdivide(context, first);
+        subdivide(context, second);
+    }
+}
+
+void renderMarianiSilver (TileContext const& context, Tile const& tile)
+{
+    if (tile.width <= 2 || tile.height <= 2) {
+        context.computeRectangle(tile);
+        return;
+    }
+
+    Rectangle rectangle;
+    rectangle.x0 = tile.x;
+    rectangle.y0 = tile.y;
+    rectangle.x1 = tile.x + tile.width - 1;
+    rectangle.y1 = tile.y + tile.height - 1;
+
+    std::vector<Pixel>& border = context.pixels;
+    border.clear();
+    for (unsigned int x = rectangle.x0; x <= rectangle.x1; ++x) {
+        border.push_back(Pixel{x, rectangle.y0});
+        border.push_back(Pixel{x, rectangle.y1});
+    }
+    for (unsigned int y = rectangle.y0 + 1; y < rectangle.y1; ++y) {
+        border.push_back(Pixel{rectangle.x0, y});
+        border.push_back(Pixel{rectangle.x1, y});
+    }
+    context.computePixels();
+
+    subdivide(context, rectangle);
+}
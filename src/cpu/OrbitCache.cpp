@@ -0,0 +1,99 @@
+#include "cpu/OrbitCache.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+    /* Count of the pixels that never escape, whatever maxIter */
+    const unsigned int interiorCount = ~0u;
+}
+
+OrbitCache::OrbitCache():
+            _valid(false)
+{
+}
+
+void OrbitCache::reset (RenderParameters const& parameters, IterationBuffer const& buffer)
+{
+    _parameters = parameters;
+    _valid = true;
+    _counts = buffer;
+    _orbits.clear();
+
+    for (unsigned int y = 0; y < buffer.getHeight(); ++y) {
+        for (unsigned int x = 0; x < buffer.getWidth(); ++x) {
+            if (buffer.at(x, y) >= parameters.maxIter) {
+                Orbit orbit;
+                orbit.pixel = Pixel{x, y};
+                orbit.iter = 0;
+                orbit.interior = false;
+                orbit.zx = orbit.zy = orbit.zxLo = orbit.zyLo = orbit.zxTail = orbit.zyTail = 0.0;
+                _orbits.push_back(orbit);
+            }
+        }
+    }
+}
+
+void OrbitCache::clear()
+{
+    _valid = false;
+    _counts.resize(0, 0);
+    _orbits.clear();
+}
+
+bool OrbitCache::holds (RenderParameters const& parameters) const
+{
+    if (!_valid)
+        return false;
+
+    RenderParameters other = parameters;
+    other.maxIter = _parameters.maxIter;
+    return isSameFractal(_parameters, other) && isSameView(_parameters, parameters);
+}
+
+RenderParameters const& OrbitCache::getParameters() const
+{
+    return _parameters;
+}
+
+unsigned int OrbitCache::getWidth() const
+{
+    return _counts.getWidth();
+}
+
+unsigned int OrbitCache::getHeight() const
+{
+    return _counts.getHeight();
+}
+
+std::size_t OrbitCache::prepare (unsigned int maxIter)
+{
+    std::vector<Orbit>::iterator end = std::partition(_orbits.begin(), _orbits.end(), [maxIter](Orbit const& orbit) {
+        return orbit.iter < maxIter;
+    });
+    return end - _orbits.begin();
+}
+
+Orbit* OrbitCache::getOrbits()
+{
+    return _orbits.data();
+}
+
+void OrbitCache::update (unsigned int maxIter, IterationBuffer& buffer)
+{
+    for (Orbit const& orbit : _orbits) {
+        _counts.at(orbit.pixel.x, orbit.pixel.y) = orbit.interior ? interiorCount : orbit.iter;
+    }
+    _orbits.erase(std::remove_if(_orbits.begin(), _orbits.end(), [maxIter](Orbit const& orbit) {
+        return orbit.interior || orbit.iter < maxIter;
+    }), _orbits.end());
+    _parameters.maxIter = maxIter;
+
+    buffer.resize(_counts.getWidth(), _counts.getHeight());
+    for (unsigned int y = 0; y < buffer.getHeight(); ++y) {
+        for (unsigned int x = 0; x < buffer.getWidth(); ++x) {
+            buffer.at(x, y) = std::min(_counts.at(x, y), maxIter);
+        }
+    }
+}
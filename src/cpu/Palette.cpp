@@ -0,0 +1,62 @@
+#include "cpu/Palette.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+
+Palette::Palette (std::uint8_t const* rgba, unsigned int width):
+            _colors(rgba, rgba + 4*width)
+{
+    if (width == 0)
+        throw std::runtime_error("Palette: empty palette");
+}
+
+Palette Palette::grayscale()
+{
+    std::vector<std::uint8_t> colors(4*256);
+    for (unsigned int i = 0; i < 256; ++i) {
+        colors[4*i + 0] = colors[4*i + 1] = colors[4*i + 2] = i;
+        colors[4*i + 3] = 255;
+    }
+
+    return Palette(colors.data(), 256);
+}
+
+unsigned int Palette::getWidth() const
+{
+    return _colors.size() / 4;
+}
+
+void Palette::sample (float r, std::uint8_t* rgba) const
+{
+    /* Texel i is centered on (i+0.5) / width */
+    const int last = static_cast<int>(getWidth()) - 1;
+    float u = r * getWidth() - 0.5f;
+    float fi = std::floor(u);
+    float t = u - fi;
+
+    int i0 = static_cast<int>(fi), i1 = i0 + 1;
+    i0 = (i0 < 0) ? 0 : ((i0 > last) ? last : i0);
+    i1 = (i1 < 0) ? 0 : ((i1 > last) ? last : i1);
+
+    for (unsigned int c = 0; c < 4; ++c) {
+        float value = (1.f - t) * _colors[4*i0 + c] + t * _colors[4*i1 + c];
+        rgba[c] = static_cast<std::uint8_t>(value + 0.5f);
+    }
+}
+
+void Palette::colorize (IterationBuffer const& buffer, unsigned int maxIter, std::vector<std::uint8_t>& rgba,
+                        float offset) const
+{
+    std::vector<unsigned int> const& iterations = buffer.getData();
+    rgba.resize(4 * iterations.size());
+
+    for (std::size_t i = 0; i < iterations.size(); ++i) {
+        float r = static_cast<float>(iterations[i]) / static_cast<float>(maxIter);
+        if (iterations[i] < maxIter) {
+            r += offset;
+            r -= std::floor(r);
+        }
+        sample(r, &rgba[4*i]);
+    }
+}
@@ -0,0 +1,55 @@
+#include "cpu/Pan.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+
+bool findPan (RenderParameters const& previous, RenderParameters const& current,
+              unsigned int width, unsigned int height, Pan& pan)
+{
+    if (!isSameFractal(previous, current))
+        return false;
+
+    /* Pixel (x,y) of either view is at anchor + (x - middle + panPixels) steps, see PixelMapping */
+    if (previous.invViewMatrix[0] != current.invViewMatrix[0] || previous.invViewMatrix[1] != current.invViewMatrix[1]
+        || previous.anchor != current.anchor)
+        return false;
+
+    pan.offsetX = current.panPixels.x - previous.panPixels.x;
+    pan.offsetY = current.panPixels.y - previous.panPixels.y;
+    return std::abs(pan.offsetX) < static_cast<int>(width) && std::abs(pan.offsetY) < static_cast<int>(height);
+}
+
+std::vector<Tile> applyPan (Pan const& pan, IterationBuffer& buffer)
+{
+    const int width = static_cast<int>(buffer.getWidth()), height = static_cast<int>(buffer.getHeight());
+    const int dx = pan.offsetX, dy = pan.offsetY;
+
+    /* Kept pixels of the new view */
+    const int x0 = std::max(0, -dx), x1 = std::min(width, width - dx);
+    const int y0 = std::max(0, -dy), y1 = std::min(height, height - dy);
+
+    /* Rows are read before being overwritten, and so are pixels within a row when dy is 0 */
+    if (x0 < x1) {
+        for (int i = 0; i < y1 - y0; ++i) {
+            int y = (dy > 0) ? y0 + i : y1 - 1 - i;
+            unsigned int const* source = &buffer.at(x0 + dx, y + dy);
+            unsigned int* destination = &buffer.at(x0, y);
+            if (dx >= 0)
+                std::copy(source, source + (x1 - x0), destination);
+            else
+                std::copy_backward(source, source + (x1 - x0), destination + (x1 - x0));
+        }
+    }
+
+    /* Exposed columns over the whole height, then exposed rows over the kept columns */
+    std::vector<Tile> exposed;
+    if (dx != 0)
+        exposed.push_back(Tile{static_cast<unsigned int>(dx > 0 ? x1 : 0), 0,
+                               static_cast<unsigned int>(std::abs(dx)), buffer.getHeight()});
+    if (dy != 0 && x0 < x1)
+        exposed.push_back(Tile{static_cast<unsigned int>(x0), static_cast<unsigned int>(dy > 0 ? y1 : 0),
+                               static_cast<unsigned int>(x1 - x0), static_cast<unsigned int>(std::abs(dy))});
+
+    return exposed;
+}
@@ -0,0 +1,111 @@
+#include "cpu/PrecisionLadder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+
+char const* getPrecisionName (Precision precision)
+{
+    switch (precision) {
+        case Precision::Float:
+            return "float";
+        case Precision::DoubleFloat:
+            return "double-float";
+        case Precision::Double:
+            return "double";
+        case Precision::DoubleDouble:
+            return "double-double";
+        case Precision::Fixed128:
+            return "fixed128";
+    }
+    return "unknown";
+}
+
+double getPrecisionEpsilon (Precision precision)
+{
+    switch (precision) {
+        case Precision::Float:
+            return std::numeric_limits<float>::epsilon();
+        case Precision::DoubleFloat:
+            return std::ldexp(1.0, -46); //48 bits, minus the rounding of the non-exact operations
+        case Precision::Double:
+            return std::numeric_limits<double>::epsilon();
+        case Precision::DoubleDouble:
+            return std::ldexp(1.0, -104); //106 bits, minus the rounding of the non-exact operations
+        case Precision::Fixed128:
+            return std::ldexp(1.0, -120);
+    }
+    return 0.0;
+}
+
+double getPixelUlps (Precision precision, RenderParameters const& parameters, unsigned int width, unsigned int height)
+{
+    PixelMapping mapping(parameters, width, height);
+
+    /* The view is a parallelogram: its largest coordinate is at one of its corners */
+    double magnitude = 0.0;
+    const double xs[] = {0.0, width - 1.0}, ys[] = {0.0, height - 1.0};
+    for (double x : xs) {
+        for (double y : ys) {
+            glm::dvec2 corner = mapping.toWorld(x, y);
+            magnitude = std::max(magnitude, std::max(std::abs(corner.x), std::abs(corner.y)));
+        }
+    }
+
+    const double ulp = getPrecisionEpsilon(precision) * ((precision == Precision::Fixed128) ? 1.0 : magnitude);
+    if (ulp == 0.0)
+        return std::numeric_limits<double>::infinity();
+
+    return mapping.getPixelSize() / ulp;
+}
+
+
+PrecisionLadder::PrecisionLadder():
+            _current(0),
+            _resolvesView(true)
+{
+}
+
+void PrecisionLadder::add (Precision precision)
+{
+    if (!_tiers.empty() && precision <= _tiers.back())
+        throw std::runtime_error("formats of the precision ladder have to be added from the least precise");
+
+    _tiers.push_back(precision);
+}
+
+bool PrecisionLadder::select (RenderParameters const& parameters, unsigned int width, unsigned int height)
+{
+    if (_tiers.empty())
+        throw std::runtime_error("empty precision ladder");
+
+    std::size_t selected = _tiers.size() - 1;
+    _resolvesView = false;
+    for (std::size_t i = 0; i < _tiers.size(); ++i) {
+        const double margin = (i < _current) ? 2.0 * minPixelUlps : minPixelUlps;
+        if (getPixelUlps(_tiers[i], parameters, width, height) >= margin) {
+            selected = i;
+            _resolvesView = true;
+            break;
+        }
+    }
+
+    const bool changed = (selected != _current);
+    _current = selected;
+    return changed;
+}
+
+Precision PrecisionLadder::getPrecision() const
+{
+    if (_tiers.empty())
+        throw std::runtime_error("empty precision ladder");
+
+    return _tiers[_current];
+}
+
+bool PrecisionLadder::resolvesView() const
+{
+    return _resolvesView;
+}
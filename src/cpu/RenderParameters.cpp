@@ -0,0 +1,63 @@
+#include "cpu/RenderParameters.hpp"
+
+
+RenderParameters::RenderParameters():
+            type(FractalType::Mandelbrot),
+            seed(0.0, 0.0),
+            maxIter(100),
+            invViewMatrix(1.0),
+            anchor(0.0, 0.0),
+            panPixels(0, 0),
+            cardioidCheck(true),
+            periodicityCheck(true),
+            periodicityTolerance(defaultPeriodicityTolerance),
+            intervalCheck(true),
+            symmetryCheck(true),
+            step(1),
+            knownStep(0)
+{
+}
+
+bool isSameFractal (RenderParameters const& a, RenderParameters const& b)
+{
+    return a.type == b.type && a.maxIter == b.maxIter &&
+           (a.type != FractalType::Julia || a.seed == b.seed) &&
+           a.cardioidCheck == b.cardioidCheck &&
+           a.periodicityCheck == b.periodicityCheck &&
+           a.periodicityTolerance == b.periodicityTolerance;
+}
+
+bool isSameView (RenderParameters const& a, RenderParameters const& b)
+{
+    return a.invViewMatrix == b.invViewMatrix && a.anchor == b.anchor && a.panPixels == b.panPixels;
+}
+
+PixelMapping::PixelMapping (RenderParameters const& parameters, unsigned int width, unsigned int height)
+{
+    /* Window coordinates of pixel (x,y) are (2(x+0.5)/width - 1, 2(y+0.5)/height - 1) */
+    glm::dmat3 const& matrix = parameters.invViewMatrix;
+    _stepX = glm::dvec2(matrix[0]) * (2.0 / width);
+    _stepY = glm::dvec2(matrix[1]) * (2.0 / height);
+    _center = parameters.anchor;
+    _middle = 0.5 * glm::dvec2(width - 1.0, height - 1.0) - glm::dvec2(parameters.panPixels);
+}
+
+glm::dvec2 const& PixelMapping::getCenter() const
+{
+    return _center;
+}
+
+glm::dvec2 const& PixelMapping::getStepX() const
+{
+    return _stepX;
+}
+
+glm::dvec2 const& PixelMapping::getStepY() const
+{
+    return _stepY;
+}
+
+double PixelMapping::getPixelSize() const
+{
+    return glm::min(glm::length(_stepX), glm::length(_stepY));
+}
@@ -0,0 +1,43 @@
+#include "cpu/RenderStats.hpp"
+
+
+RenderStats::RenderStats():
+            pixels(0),
+            computedPixels(0),
+            classifiedPixels(0),
+            culledPixels(0),
+            mirroredPixels(0),
+            iterations(0),
+            cardioidSkipped(0),
+            periodicExits(0),
+            seconds(0.0)
+{
+}
+
+void RenderStats::merge (RenderStats const& other)
+{
+    pixels += other.pixels;
+    computedPixels += other.computedPixels;
+    classifiedPixels += other.classifiedPixels;
+    culledPixels += other.culledPixels;
+    mirroredPixels += other.mirroredPixels;
+    iterations += other.iterations;
+    cardioidSkipped += other.cardioidSkipped;
+    periodicExits += other.periodicExits;
+}
+
+double RenderStats::getMegaPixelsPerSecond() const
+{
+    if (seconds <= 0.0)
+        return 0.0;
+
+    return static_cast<double>(pixels) / seconds * 1e-6;
+}
+
+double RenderStats::getComputedFraction() const
+{
+    if (pixels == 0)
+        return 0.0;
+
+    return static_cast<double>(computedPixels) / static_cast<double>(pixels);
+}
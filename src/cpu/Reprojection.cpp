@@ -0,0 +1,105 @@
+#include "cpu/Reprojection.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+
+namespace
+{
+    unsigned int difference (unsigned int a, unsigned int b)
+    {
+        return (a > b) ? a - b : b - a;
+    }
+
+    /* Nearest pixel coordinate in [0, size[ of a coordinate in pixels */
+    unsigned int toNearest (double coordinate, unsigned int size, bool& inside)
+    {
+        double shifted = coordinate + 0.5; //truncation then rounds to the nearest
+        if (!(shifted >= 0.0)) {
+            inside = false;
+            return 0;
+        }
+        if (shifted >= size) {
+            inside = false;
+            return size - 1;
+        }
+        return static_cast<unsigned int>(shifted);
+    }
+}
+
+Reprojection reproject (RenderParameters const& previous, IterationBuffer const& source,
+                        RenderParameters const& current, IterationBuffer& destination,
+                        unsigned int tileSize)
+{
+    const unsigned int width = destination.getWidth(), height = destination.getHeight();
+    const unsigned int sourceWidth = source.getWidth(), sourceHeight = source.getHeight();
+
+    Reprojection reprojection;
+    reprojection.coverage = 0.0;
+    reprojection.tiles = splitInTiles(width, height, tileSize);
+    if (reprojection.tiles.empty() || sourceWidth == 0 || sourceHeight == 0)
+        return reprojection;
+
+    /* Pixel coordinates in source are an affine function of those in destination */
+    PixelMapping from(previous, sourceWidth, sourceHeight);
+    PixelMapping to(current, width, height);
+    glm::dvec2 const& stepX = from.getStepX();
+    glm::dvec2 const& stepY = from.getStepY();
+    const double det = stepX.x * stepY.y - stepY.x * stepX.y;
+    if (det == 0.0)
+        return reprojection;
+
+    auto toSourcePixels = [&](glm::dvec2 const& world) {
+        return glm::dvec2((stepY.y * world.x - stepY.x * world.y) / det,
+                          (stepX.x * world.y - stepX.y * world.x) / det);
+    };
+    const glm::dvec2 base = toSourcePixels(to.toWorld(0.0, 0.0) - from.toWorld(0.0, 0.0));
+    const glm::dvec2 sourceStepX = toSourcePixels(to.getStepX());
+    const glm::dvec2 sourceStepY = toSourcePixels(to.getStepY());
+
+    /* Tiles come row after row, see splitInTiles() */
+    const unsigned int tilesPerRow = (width + tileSize - 1) / tileSize;
+    std::vector<double> errors(reprojection.tiles.size(), 0.0);
+
+    std::uint64_t covered = 0;
+    for (unsigned int y = 0; y < height; ++y) {
+        double* rowErrors = &errors[(y / tileSize) * tilesPerRow];
+        glm::dvec2 rowBase = base + static_cast<double>(y) * sourceStepY;
+        for (unsigned int x = 0; x < width; ++x) {
+            glm::dvec2 position = rowBase + static_cast<double>(x) * sourceStepX;
+            bool inside = true;
+            unsigned int sourceX = toNearest(position.x, sourceWidth, inside);
+            unsigned int sourceY = toNearest(position.y, sourceHeight, inside);
+
+            unsigned int count = source.at(sourceX, sourceY);
+            destination.at(x, y) = count;
+
+            unsigned int error = current.maxIter;
+            if (inside) {
+                ++covered;
+                unsigned int right = source.at(std::min(sourceX + 1, sourceWidth - 1), sourceY);
+                unsigned int up = source.at(sourceX, std::min(sourceY + 1, sourceHeight - 1));
+                error = std::min(error, difference(count, right) + difference(count, up));
+            }
+            rowErrors[x / tileSize] += error;
+        }
+    }
+    reprojection.coverage = static_cast<double>(covered) / (static_cast<double>(width) * height);
+
+    std::vector<std::size_t> order(reprojection.tiles.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return errors[a] > errors[b];
+    });
+
+    std::vector<Tile> sorted;
+    sorted.reserve(order.size());
+    for (std::size_t i : order) {
+        sorted.push_back(reprojection.tiles[i]);
+    }
+    reprojection.tiles.swap(sorted);
+
+    return reprojection;
+}
@@ -0,0 +1,257 @@
+#include "cpu/SIMDKernel.hpp"
+
+#include "cpu/Bailout.hpp"
+#include "cpu/EscapeTimeSIMD.hpp"
+#include "cpu/ScalarKernel.hpp"
+
+#include <stdexcept>
+
+
+SIMDLevel getBestSIMDLevel()
+{
+    static const SIMDLevel best = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return SIMDLevel::AVX512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return SIMDLevel::AVX2;
+        return SIMDLevel::SSE2;
+    }();
+
+    return best;
+}
+
+char const* getSIMDLevelName (SIMDLevel level)
+{
+    switch (level) {
+        case SIMDLevel::SSE2:
+            return "sse2";
+        case SIMDLevel::AVX2:
+            return "avx2";
+        case SIMDLevel::AVX512:
+            return "avx512";
+    }
+
+    return "unknown";
+}
+
+
+template<typename T>
+SIMDKernel<T>::SIMDKernel (LaneMode laneMode, unsigned int bailoutInterval):
+            SIMDKernel(getBestSIMDLevel(), laneMode, bailoutInterval)
+{
+}
+
+template<typename T>
+SIMDKernel<T>::SIMDKernel (SIMDLevel level, LaneMode laneMode, unsigned int bailoutInterval):
+            _level(level),
+            _laneMode(laneMode),
+            _bailoutInterval(bailoutInterval),
+            _name(std::string(getSIMDLevelName(level)) + "-" + getRealName<T>())
+{
+    if (!isSupportedBailoutInterval(bailoutInterval))
+        throw std::runtime_error("SIMDKernel: unsupported bailout interval " + std::to_string(bailoutInterval));
+
+    if (laneMode == LaneMode::Refill)
+        _name += "-refill";
+    if (bailoutInterval > 1)
+        _name += "-defer" + std::to_string(bailoutInterval);
+
+    if (level > getBestSIMDLevel())
+        throw std::runtime_error(std::string("SIMDKernel: ") + getSIMDLevelName(level) + " is not supported by this CPU");
+}
+
+template<typename T>
+SIMDLevel SIMDKernel<T>::getLevel() const
+{
+    return _level;
+}
+
+template<typename T>
+LaneMode SIMDKernel<T>::getLaneMode() const
+{
+    return _laneMode;
+}
+
+template<typename T>
+unsigned int SIMDKernel<T>::getBailoutInterval() const
+{
+    return _bailoutInterval;
+}
+
+template<typename T>
+char const* SIMDKernel<T>::getName() const
+{
+    return _name.c_str();
+}
+
+namespace
+{
+    /* Pixels go through the vector loops in chunks small enough to stay on the stack,
+     * but large enough for the lanes to be refilled many times before draining
+     */
+    const std::size_t chunkSize = 1024;
+
+    /* Everything but the points */
+    template<typename T>
+    SIMDInput<T> makeInput (RenderParameters const& parameters, PixelMapping const& mapping,
+                            LaneMode laneMode, unsigned int bailoutInterval)
+    {
+        SIMDInput<T> input;
+        input.x = input.y = nullptr;
+        input.count = 0;
+        input.julia = (parameters.type == FractalType::Julia);
+        input.seedX = toReal<T>(parameters.seed.x);
+        input.seedY = toReal<T>(parameters.seed.y);
+        input.cx = input.cy = nullptr;
+        input.lastX = input.lastY = nullptr;
+        input.maxIter = parameters.maxIter;
+        input.refillLanes = (laneMode == LaneMode::Refill);
+        input.bailoutInterval = bailoutInterval;
+
+        const double tolerance = parameters.periodicityTolerance * mapping.getPixelSize();
+        input.periodicityCheck = parameters.periodicityCheck;
+        input.tolerance2 = toReal<T>(tolerance * tolerance);
+        return input;
+    }
+
+    template<typename T>
+    void escapeTimeSIMD (SIMDLevel level, SIMDInput<T> const& input, unsigned int* iterations, bool* periodic)
+    {
+        switch (level) {
+            case SIMDLevel::SSE2:
+                escapeTimeSSE2(input, iterations, periodic);
+            break;
+            case SIMDLevel::AVX2:
+                escapeTimeAVX2(input, iterations, periodic);
+            break;
+            case SIMDLevel::AVX512:
+                escapeTimeAVX512(input, iterations, periodic);
+            break;
+        }
+    }
+}
+
+template<typename T>
+void SIMDKernel<T>::compute (RenderParameters const& parameters, PixelMapping const& mapping,
+                             Pixel const* pixels, std::size_t count,
+                             IterationBuffer& buffer, RenderStats& stats) const
+{
+    alignas(64) T x[chunkSize], y[chunkSize];
+    unsigned int iterations[chunkSize];
+    bool periodic[chunkSize];
+    Pixel chunk[chunkSize];
+
+    SIMDInput<T> input = makeInput<T>(parameters, mapping, _laneMode, _bailoutInterval);
+    input.x = x;
+    input.y = y;
+
+    const bool cardioidCheck = !input.julia && parameters.cardioidCheck;
+
+    std::size_t next = 0;
+    while (next < count) {
+        input.count = 0;
+        for (; next < count && input.count < chunkSize; ++next) {
+            glm::dvec2 pos = mapping.toWorld(pixels[next].x, pixels[next].y);
+            if (cardioidCheck && isInCardioidOrBulb(pos)) {
+                buffer.at(pixels[next].x, pixels[next].y) = parameters.maxIter;
+                ++stats.cardioidSkipped;
+                continue;
+            }
+
+            chunk[input.count] = pixels[next];
+            toKernelPosition(mapping, pixels[next].x, pixels[next].y, x[input.count], y[input.count]);
+            ++input.count;
+        }
+
+        escapeTimeSIMD(_level, input, iterations, periodic);
+
+        for (std::size_t i = 0; i < input.count; ++i) {
+            buffer.at(chunk[i].x, chunk[i].y) = periodic[i] ? parameters.maxIter : iterations[i];
+            stats.iterations += iterations[i];
+            if (periodic[i])
+                ++stats.periodicExits;
+        }
+    }
+}
+
+template<typename T>
+void SIMDKernel<T>::resume (RenderParameters const& parameters, PixelMapping const& mapping,
+                            Orbit* orbits, std::size_t count, RenderStats& stats) const
+{
+    alignas(64) T x[chunkSize], y[chunkSize], cx[chunkSize], cy[chunkSize], lastX[chunkSize], lastY[chunkSize];
+    unsigned int iterations[chunkSize];
+    bool periodic[chunkSize];
+    Orbit* chunk[chunkSize];
+
+    SIMDInput<T> input = makeInput<T>(parameters, mapping, _laneMode, _bailoutInterval);
+    input.x = x;
+    input.y = y;
+    input.lastX = lastX;
+    input.lastY = lastY;
+    if (!input.julia) {
+        input.cx = cx;
+        input.cy = cy;
+    }
+
+    const bool cardioidCheck = !input.julia && parameters.cardioidCheck;
+
+    /* The vector loops take a single maxIter: a chunk only holds orbits that ran as many iterations */
+    std::size_t next = 0;
+    while (next < count) {
+        input.count = 0;
+        unsigned int start = 0;
+        for (; next < count && input.count < chunkSize; ++next) {
+            Orbit& orbit = orbits[next];
+            if (orbit.interior || orbit.iter >= parameters.maxIter)
+                continue;
+            if (input.count > 0 && orbit.iter != start)
+                break;
+
+            if (orbit.iter == 0 && cardioidCheck && isInCardioidOrBulb(mapping.toWorld(orbit.pixel.x, orbit.pixel.y))) {
+                orbit.interior = true;
+                ++stats.cardioidSkipped;
+                continue;
+            }
+
+            start = orbit.iter;
+            chunk[input.count] = &orbit;
+            toKernelPosition(mapping, orbit.pixel.x, orbit.pixel.y, cx[input.count], cy[input.count]);
+            if (orbit.iter == 0) {
+                x[input.count] = cx[input.count];
+                y[input.count] = cy[input.count];
+            } else {
+                loadOrbit(orbit, x[input.count], y[input.count]);
+            }
+            ++input.count;
+        }
+        if (input.count == 0)
+            continue;
+
+        input.maxIter = parameters.maxIter - start;
+        escapeTimeSIMD(_level, input, iterations, periodic);
+
+        for (std::size_t i = 0; i < input.count; ++i) {
+            Orbit& orbit = *chunk[i];
+            orbit.iter += iterations[i];
+            orbit.interior = periodic[i];
+            saveOrbit(lastX[i], lastY[i], orbit);
+            stats.iterations += iterations[i];
+            if (periodic[i])
+                ++stats.periodicExits;
+        }
+    }
+}
+
+template<typename T>
+void SIMDKernel<T>::computeDistances (RenderParameters const& parameters, PixelMapping const& mapping,
+                                      Pixel const* pixels, std::size_t count,
+                                      IterationBuffer& buffer, DistanceEstimate* estimates,
+                                      RenderStats& stats) const
+{
+    computeDistanceEstimates<T>(parameters, mapping, pixels, count, buffer, estimates, stats);
+}
+
+template class SIMDKernel<float>;
+template class SIMDKernel<double>;
+template class SIMDKernel<DoubleDouble>;
@@ -0,0 +1,275 @@
+#include "cpu/ScalarKernel.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+
+template<typename T>
+ScalarKernel<T>::ScalarKernel (unsigned int bailoutInterval):
+            _bailoutInterval(bailoutInterval),
+            _name(std::string("scalar-") + getRealName<T>())
+{
+    if (!isSupportedBailoutInterval(bailoutInterval))
+        throw std::runtime_error("ScalarKernel: unsupported bailout interval " + std::to_string(bailoutInterval));
+
+    if (bailoutInterval > 1)
+        _name += "-defer" + std::to_string(bailoutInterval);
+}
+
+template<typename T>
+unsigned int ScalarKernel<T>::getBailoutInterval() const
+{
+    return _bailoutInterval;
+}
+
+template<typename T>
+char const* ScalarKernel<T>::getName() const
+{
+    return _name.c_str();
+}
+
+namespace
+{
+
+/* Iterates from z with the escape-time loop the options call for, leaving z where the orbit stopped.
+ * Escape tests are only deferred without cycle detection, see escapeTimeDeferred.
+ */
+template<typename T, unsigned int N>
+unsigned int iterate (T& x, T& y, T cx, T cy, unsigned int maxIter,
+                      bool periodicityCheck, T tolerance2, bool& periodic)
+{
+    periodic = false;
+    if (!periodicityCheck) {
+        return (N > 1) ? escapeTimeDeferred<T, N>(x, y, cx, cy, maxIter) :
+                         escapeTime<T>(x, y, cx, cy, maxIter);
+    }
+
+    CycleDetector<T> detector(x, y, tolerance2);
+    unsigned int iter = escapeTimePeriodic<T>(x, y, cx, cy, maxIter, detector);
+    periodic = detector.isPeriodic();
+    return iter;
+}
+
+template<typename T, unsigned int N>
+void computePixels (RenderParameters const& parameters, PixelMapping const& mapping,
+                    Pixel const* pixels, std::size_t count,
+                    IterationBuffer& buffer, RenderStats& stats)
+{
+    const bool julia = (parameters.type == FractalType::Julia);
+    const bool cardioidCheck = !julia && parameters.cardioidCheck;
+    const T seedX = toReal<T>(parameters.seed.x);
+    const T seedY = toReal<T>(parameters.seed.y);
+
+    const double tolerance = parameters.periodicityTolerance * mapping.getPixelSize();
+    const T tolerance2 = toReal<T>(tolerance * tolerance);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        glm::dvec2 pos = mapping.toWorld(pixels[i].x, pixels[i].y);
+        if (cardioidCheck && isInCardioidOrBulb(pos)) {
+            buffer.at(pixels[i].x, pixels[i].y) = parameters.maxIter;
+            ++stats.cardioidSkipped;
+            continue;
+        }
+
+        T x, y;
+        toKernelPosition(mapping, pixels[i].x, pixels[i].y, x, y);
+        T cx = julia ? seedX : x, cy = julia ? seedY : y;
+
+        bool periodic;
+        unsigned int iter = iterate<T, N>(x, y, cx, cy, parameters.maxIter,
+                                          parameters.periodicityCheck, tolerance2, periodic);
+
+        buffer.at(pixels[i].x, pixels[i].y) = periodic ? parameters.maxIter : iter;
+        stats.iterations += iter;
+        if (periodic)
+            ++stats.periodicExits;
+    }
+}
+
+template<typename T, unsigned int N>
+void resumeOrbits (RenderParameters const& parameters, PixelMapping const& mapping,
+                   Orbit* orbits, std::size_t count, RenderStats& stats)
+{
+    const bool julia = (parameters.type == FractalType::Julia);
+    const bool cardioidCheck = !julia && parameters.cardioidCheck;
+    const T seedX = toReal<T>(parameters.seed.x);
+    const T seedY = toReal<T>(parameters.seed.y);
+
+    const double tolerance = parameters.periodicityTolerance * mapping.getPixelSize();
+    const T tolerance2 = toReal<T>(tolerance * tolerance);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        Orbit& orbit = orbits[i];
+        if (orbit.interior || orbit.iter >= parameters.maxIter)
+            continue;
+
+        T posX, posY;
+        toKernelPosition(mapping, orbit.pixel.x, orbit.pixel.y, posX, posY);
+        T x = posX, y = posY;
+        if (orbit.iter == 0) {
+            if (cardioidCheck && isInCardioidOrBulb(mapping.toWorld(orbit.pixel.x, orbit.pixel.y))) {
+                orbit.interior = true;
+                ++stats.cardioidSkipped;
+                continue;
+            }
+        } else {
+            loadOrbit(orbit, x, y);
+        }
+        T cx = julia ? seedX : posX, cy = julia ? seedY : posY;
+
+        bool periodic;
+        unsigned int iter = iterate<T, N>(x, y, cx, cy, parameters.maxIter - orbit.iter,
+                                          parameters.periodicityCheck, tolerance2, periodic);
+
+        orbit.iter += iter;
+        orbit.interior = periodic;
+        saveOrbit(x, y, orbit);
+        stats.iterations += iter;
+        if (periodic)
+            ++stats.periodicExits;
+    }
+}
+
+}
+
+template<typename T>
+void ScalarKernel<T>::compute (RenderParameters const& parameters, PixelMapping const& mapping,
+                               Pixel const* pixels, std::size_t count,
+                               IterationBuffer& buffer, RenderStats& stats) const
+{
+    switch (_bailoutInterval) {
+        case 4:
+            computePixels<T, 4>(parameters, mapping, pixels, count, buffer, stats);
+        break;
+        case 8:
+            computePixels<T, 8>(parameters, mapping, pixels, count, buffer, stats);
+        break;
+        case 16:
+            computePixels<T, 16>(parameters, mapping, pixels, count, buffer, stats);
+        break;
+        default:
+            computePixels<T, 1>(parameters, mapping, pixels, count, buffer, stats);
+        break;
+    }
+}
+
+template<typename T>
+void ScalarKernel<T>::resume (RenderParameters const& parameters, PixelMapping const& mapping,
+                              Orbit* orbits, std::size_t count, RenderStats& stats) const
+{
+    switch (_bailoutInterval) {
+        case 4:
+            resumeOrbits<T, 4>(parameters, mapping, orbits, count, stats);
+        break;
+        case 8:
+            resumeOrbits<T, 8>(parameters, mapping, orbits, count, stats);
+        break;
+        case 16:
+            resumeOrbits<T, 16>(parameters, mapping, orbits, count, stats);
+        break;
+        default:
+            resumeOrbits<T, 1>(parameters, mapping, orbits, count, stats);
+        break;
+    }
+}
+
+template<typename T>
+void ScalarKernel<T>::computeDistances (RenderParameters const& parameters, PixelMapping const& mapping,
+                                        Pixel const* pixels, std::size_t count,
+                                        IterationBuffer& buffer, DistanceEstimate* estimates,
+                                        RenderStats& stats) const
+{
+    computeDistanceEstimates<T>(parameters, mapping, pixels, count, buffer, estimates, stats);
+}
+
+void estimateDistance (double zx, double zy, double cx, double cy, double dzx, double dzy,
+                       unsigned int iter, bool julia, DistanceEstimate& estimate)
+{
+    /* Further out, G = ln|z_n| / 2^m is known with a relative error around |c| / |z|² */
+    const double dc = julia ? 0.0 : 1.0;
+    double r2 = zx * zx + zy * zy;
+    unsigned int n = iter;
+    for (unsigned int i = 0; i < 32 && r2 < 1e20; ++i) {
+        const double newDzx = 2.0 * (zx * dzx - zy * dzy) + dc;
+        dzy = 2.0 * (zx * dzy + zy * dzx);
+        dzx = newDzx;
+
+        const double newZx = zx * zx - zy * zy + cx;
+        zy = 2.0 * zx * zy + cy;
+        zx = newZx;
+
+        r2 = zx * zx + zy * zy;
+        ++n;
+    }
+
+    double dzNorm = std::sqrt(dzx * dzx + dzy * dzy);
+    if (!std::isfinite(dzNorm) || !std::isfinite(r2) || dzNorm <= 0.0) {
+        estimate = DistanceEstimate();
+        return;
+    }
+
+    /* Mandelbrot orbits start at z_0 = c, one iteration ahead of the usual z_0 = 0 */
+    const int m = static_cast<int>(julia ? n : n + 1);
+    const double logR = 0.5 * std::log(r2);
+    const double g = std::ldexp(logR, -m);
+
+    /* ln|z| is the real part of the holomorphic log z, of derivative dz / z */
+    const double qx = (dzx * zx + dzy * zy) / r2, qy = (dzy * zx - dzx * zy) / r2;
+    const double scale = -1.0 / (std::log(2.0) * logR);
+    estimate.smoothIter = static_cast<double>(n) - std::log2(logR); //= -log2(G), minus 1 for Mandelbrot
+    estimate.gradient = glm::dvec2(scale * qx, -scale * qy);
+
+    /* sinh(G) / (2 e^G |grad G|) = (1 - e^-2G) / (2G) * G / (2 |grad G|), where G / |grad G| = |z| ln|z| / |dz|,
+     * and the first factor goes to 1 when G underflows */
+    const double shrink = (g > 0.0) ? -std::expm1(-2.0 * g) / (2.0 * g) : 1.0;
+    estimate.distance = shrink * std::sqrt(r2) * logR / (2.0 * dzNorm);
+}
+
+template<typename T>
+void computeDistanceEstimates (RenderParameters const& parameters, PixelMapping const& mapping,
+                               Pixel const* pixels, std::size_t count,
+                               IterationBuffer& buffer, DistanceEstimate* estimates, RenderStats& stats)
+{
+    const bool julia = (parameters.type == FractalType::Julia);
+    const bool cardioidCheck = !julia && parameters.cardioidCheck;
+    const T seedX = toReal<T>(parameters.seed.x);
+    const T seedY = toReal<T>(parameters.seed.y);
+
+    const double tolerance = parameters.periodicityTolerance * mapping.getPixelSize();
+    const T tolerance2 = toReal<T>(tolerance * tolerance);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        estimates[i] = DistanceEstimate();
+
+        glm::dvec2 pos = mapping.toWorld(pixels[i].x, pixels[i].y);
+        if (cardioidCheck && isInCardioidOrBulb(pos)) {
+            buffer.at(pixels[i].x, pixels[i].y) = parameters.maxIter;
+            ++stats.cardioidSkipped;
+            continue;
+        }
+
+        T x, y;
+        toKernelPosition(mapping, pixels[i].x, pixels[i].y, x, y);
+        T cx = julia ? seedX : x, cy = julia ? seedY : y;
+
+        CycleDetector<T> detector(x, y, tolerance2);
+        unsigned int iter = escapeTimeDistance<T>(x, y, cx, cy, parameters.maxIter, julia, estimates[i],
+                                                  parameters.periodicityCheck ? &detector : nullptr);
+
+        buffer.at(pixels[i].x, pixels[i].y) = detector.isPeriodic() ? parameters.maxIter : iter;
+        stats.iterations += iter;
+        if (detector.isPeriodic())
+            ++stats.periodicExits;
+    }
+}
+
+template void computeDistanceEstimates<float> (RenderParameters const&, PixelMapping const&, Pixel const*, std::size_t,
+                                               IterationBuffer&, DistanceEstimate*, RenderStats&);
+template void computeDistanceEstimates<double> (RenderParameters const&, PixelMapping const&, Pixel const*, std::size_t,
+                                                IterationBuffer&, DistanceEstimate*, RenderStats&);
+template void computeDistanceEstimates<DoubleDouble> (RenderParameters const&, PixelMapping const&, Pixel const*, std::size_t,
+                                                      IterationBuffer&, DistanceEstimate*, RenderStats&);
+
+template class ScalarKernel<float>;
+template class ScalarKernel<double>;
+template class ScalarKernel<DoubleDouble>;
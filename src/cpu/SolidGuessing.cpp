@@ -0,0 +1,174 @@
+#include "cpu/SolidGuessing.hpp"
+
+
+namespace
+{
+    const unsigned int firstStep = 4;
+
+    enum : std::uint8_t
+    {
+        Unknown = 0,
+        Computed = 1
+    };
+
+    /* Bounds are inclusive, and the corners are computed */
+    struct Block
+    {
+        unsigned int x0, y0;
+        unsigned int x1, y1;
+    };
+
+    class Guesser
+    {
+        public:
+            Guesser (TileContext const& context, Tile const& tile):
+                        _context(context),
+                        _tile(tile)
+            {
+                _context.flags.assign(static_cast<std::size_t>(tile.width) * tile.height, Unknown);
+                _context.pixels.clear();
+                _blocks.clear();
+                _guesses.clear();
+            }
+
+            void run()
+            {
+                /* Grid of every 4th pixel, the last row and column of the tile included */
+                std::vector<unsigned int> columns, rows;
+                for (unsigned int x = 0; x < _tile.width; x += firstStep) {
+                    columns.push_back(_tile.x + x);
+                }
+                if (columns.back() != _tile.x + _tile.width - 1)
+                    columns.push_back(_tile.x + _tile.width - 1);
+                for (unsigned int y = 0; y < _tile.height; y += firstStep) {
+                    rows.push_back(_tile.y + y);
+                }
+                if (rows.back() != _tile.y + _tile.height - 1)
+                    rows.push_back(_tile.y + _tile.height - 1);
+
+                for (unsigned int y : rows) {
+                    for (unsigned int x : columns) {
+                        enqueue(x, y);
+                    }
+                }
+                computeQueue();
+
+                if (columns.size() == 1 || rows.size() == 1) {
+                    computeRemaining(Block{_tile.x, _tile.y, columns.back(), rows.back()});
+                    computeQueue();
+                    return;
+                }
+
+                for (std::size_t j = 0; j + 1 < rows.size(); ++j) {
+                    for (std::size_t i = 0; i + 1 < columns.size(); ++i) {
+                        _blocks.push_back(Block{columns[i], rows[j], columns[i+1], rows[j+1]});
+                    }
+                }
+
+                /* 4x4 blocks, then 2x2 blocks */
+                while (!_blocks.empty()) {
+                    _current.swap(_blocks);
+                    _blocks.clear();
+                    for (Block const& block : _current) {
+                        refine(block);
+                    }
+                    computeQueue();
+                }
+
+                fill();
+            }
+
+        private:
+            std::uint8_t& flag (unsigned int x, unsigned int y)
+            {
+                return _context.flags[(y - _tile.y) * _tile.width + (x - _tile.x)];
+            }
+
+            void enqueue (unsigned int x, unsigned int y)
+            {
+                std::uint8_t& f = flag(x, y);
+                if (f == Unknown) {
+                    f = Computed; //as soon as the queue is
+                    _context.pixels.push_back(Pixel{x, y});
+                }
+            }
+
+            void computeQueue()
+            {
+                if (!_context.pixels.empty()) {
+                    _context.computePixels();
+                    _context.pixels.clear();
+                }
+            }
+
+            void computeRemaining (Block const& block)
+            {
+                for (unsigned int y = block.y0; y <= block.y1; ++y) {
+                    for (unsigned int x = block.x0; x <= block.x1; ++x) {
+                        enqueue(x, y);
+                    }
+                }
+            }
+
+            /* Either guesses the block, or queues its next level of pixels and sub-blocks */
+            void refine (Block const& block)
+            {
+                IterationBuffer const& buffer = _context.buffer;
+                unsigned int value = buffer.at(block.x0, block.y0);
+                if (buffer.at(block.x1, block.y0) == value && buffer.at(block.x0, block.y1) == value &&
+                    buffer.at(block.x1, block.y1) == value) {
+                    _guesses.push_back(block);
+                    return;
+                }
+
+                if (block.x1 - block.x0 <= 2 && block.y1 - block.y0 <= 2) {
+                    computeRemaining(block);
+                    return;
+                }
+
+                unsigned int xs[3] = {block.x0, (block.x0 + block.x1) / 2, block.x1};
+                unsigned int ys[3] = {block.y0, (block.y0 + block.y1) / 2, block.y1};
+                for (unsigned int y : ys) {
+                    for (unsigned int x : xs) {
+                        enqueue(x, y);
+                    }
+                }
+                for (unsigned int j = 0; j < 2; ++j) {
+                    for (unsigned int i = 0; i < 2; ++i) {
+                        if (xs[i] != xs[i+1] && ys[j] != ys[j+1]) //blocks one pixel thin have no sub-block on that side
+                            _blocks.push_back(Block{xs[i], ys[j], xs[i+1], ys[j+1]});
+                    }
+                }
+            }
+
+            /* Guessed blocks may share their edges with computed blocks, which are kept */
+            void fill()
+            {
+                IterationBuffer& buffer = _context.buffer;
+
+                for (Block const& block : _guesses) {
+                    unsigned int value = buffer.at(block.x0, block.y0);
+                    for (unsigned int y = block.y0; y <= block.y1; ++y) {
+                        for (unsigned int x = block.x0; x <= block.x1; ++x) {
+                            if (flag(x, y) == Unknown)
+                                buffer.at(x, y) = value;
+                        }
+                    }
+                }
+            }
+
+        private:
+            TileContext const& _context;
+            Tile const& _tile;
+
+            std::vector<Block> _blocks;
+            std::vector<Block> _current;
+            std::vector<Block> _guesses;
+    };
+}
+
+void renderSolidGuessing (TileContext const& context, Tile const& tile)
+{
+    Guesser guesser(context, tile);
+    guesser.run();
+}
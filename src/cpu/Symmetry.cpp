@@ -0,0 +1,76 @@
+#include "cpu/Symmetry.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+    /* Range [first, last[ of the coordinates c in [0, size[ whose mirror offset - c lies in [0, size[,
+     * restricted to the upper half if strict, so that a coordinate and its mirror are not both in it
+     */
+    void getMirroredRange (int offset, int size, bool strict, int& first, int& last)
+    {
+        first = std::max(0, offset - size + 1);
+        last = std::min(size, offset + 1);
+        if (strict)
+            first = std::max(first, offset / 2 + 1);
+    }
+}
+
+bool findSymmetry (RenderParameters const& parameters, PixelMapping const& mapping,
+                   unsigned int width, unsigned int height, Symmetry& symmetry)
+{
+    glm::dvec2 const& center = mapping.getCenter();
+    glm::dvec2 const& stepX = mapping.getStepX();
+    glm::dvec2 const& stepY = mapping.getStepY();
+
+    /* Pixels mirrored about the middle of the buffer have exactly opposite offsets to the anchor
+     * if the view is not panned from it, so that it has to be anchored on the origin, or on the real axis
+     */
+    if (parameters.panPixels != glm::ivec2(0, 0))
+        return false;
+
+    if (parameters.type == FractalType::Julia) {
+        if (center.x != 0.0 || center.y != 0.0)
+            return false;
+
+        symmetry.flipX = true;
+        symmetry.offsetX = static_cast<int>(width) - 1;
+    } else {
+        /* Conjugation keeps the columns only if they are vertical in the world */
+        if (stepX.y != 0.0 || stepY.x != 0.0 || stepY.y == 0.0 || center.y != 0.0)
+            return false;
+
+        symmetry.flipX = false;
+        symmetry.offsetX = 0;
+    }
+    symmetry.offsetY = static_cast<int>(height) - 1;
+
+    int x0 = 0, x1 = static_cast<int>(width);
+    if (symmetry.flipX)
+        getMirroredRange(symmetry.offsetX, static_cast<int>(width), false, x0, x1);
+
+    int y0, y1;
+    getMirroredRange(symmetry.offsetY, static_cast<int>(height), true, y0, y1);
+
+    if (x0 >= x1 || y0 >= y1)
+        return false;
+
+    symmetry.mirrored.x = static_cast<unsigned int>(x0);
+    symmetry.mirrored.y = static_cast<unsigned int>(y0);
+    symmetry.mirrored.width = static_cast<unsigned int>(x1 - x0);
+    symmetry.mirrored.height = static_cast<unsigned int>(y1 - y0);
+    return true;
+}
+
+void copyMirrored (Symmetry const& symmetry, IterationBuffer& buffer)
+{
+    Tile const& mirrored = symmetry.mirrored;
+    for (unsigned int y = mirrored.y; y < mirrored.y + mirrored.height; ++y) {
+        unsigned int sourceY = static_cast<unsigned int>(symmetry.offsetY - static_cast<int>(y));
+        for (unsigned int x = mirrored.x; x < mirrored.x + mirrored.width; ++x) {
+            unsigned int sourceX = symmetry.flipX ? static_cast<unsigned int>(symmetry.offsetX - static_cast<int>(x)) : x;
+            buffer.at(x, y) = buffer.at(sourceX, sourceY);
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#include "cpu/ThreadPool.hpp"
+
+
+ThreadPool::ThreadPool (unsigned int workerCount):
+            _task(nullptr),
+            _remainingTasks(0),
+            _generation(0),
+            _busyWorkers(0),
+            _stop(false)
+{
+    if (workerCount == 0)
+        workerCount = getHardwareThreadCount();
+
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        _queues.emplace_back(new Queue());
+    }
+    for (unsigned int i = 1; i < workerCount; ++i) {
+        _threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wakeUp.notify_all();
+
+    for (std::thread& thread : _threads) {
+        thread.join();
+    }
+}
+
+unsigned int ThreadPool::getWorkerCount() const
+{
+    return _queues.size();
+}
+
+void ThreadPool::run (std::size_t taskCount, Task const& task)
+{
+    if (taskCount == 0)
+        return;
+
+    for (std::size_t i = 0; i < taskCount; ++i) {
+        Queue& queue = *_queues[i % _queues.size()];
+        queue.tasks.push_back(i);
+    }
+    _remainingTasks = taskCount;
+    _task = &task;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _busyWorkers = _threads.size();
+        ++_generation;
+    }
+    _wakeUp.notify_all();
+
+    processTasks(0);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finished.wait(lock, [this]() { return _busyWorkers == 0; });
+    _task = nullptr;
+}
+
+unsigned int ThreadPool::getHardwareThreadCount()
+{
+    unsigned int count = std::thread::hardware_concurrency();
+    return (count == 0) ? 1 : count;
+}
+
+void ThreadPool::workerLoop (unsigned int worker)
+{
+    unsigned long lastGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeUp.wait(lock, [&]() { return _stop || _generation != lastGeneration; });
+            if (_stop)
+                return;
+            lastGeneration = _generation;
+        }
+
+        processTasks(worker);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_busyWorkers == 0)
+            _finished.notify_one();
+    }
+}
+
+void ThreadPool::processTasks (unsigned int worker)
+{
+    std::size_t task;
+    while (_remainingTasks.load(std::memory_order_acquire) > 0) {
+        if (popLocal(worker, task) || steal(worker, task)) {
+            (*_task)(task, worker);
+            _remainingTasks.fetch_sub(1, std::memory_order_acq_rel);
+        } else {
+            /* Every deque is empty: the last tasks are running on other workers */
+            return;
+        }
+    }
+}
+
+bool ThreadPool::popLocal (unsigned int worker, std::size_t& task)
+{
+    Queue& queue = *_queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal (unsigned int thief, std::size_t& task)
+{
+    const unsigned int count = _queues.size();
+
+    /* Start with the next worker so that thieves spread over the victims */
+    for (unsigned int i = 1; i < count; ++i) {
+        Queue& queue = *_queues[(thief + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,58 @@
+#include "cpu/Tile.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+    void addTiles (Tile const& area, unsigned int tileSize, std::vector<Tile>& tiles)
+    {
+        for (unsigned int y = 0; y < area.height; y += tileSize) {
+            for (unsigned int x = 0; x < area.width; x += tileSize) {
+                Tile tile;
+                tile.x = area.x + x;
+                tile.y = area.y + y;
+                tile.width = std::min(tileSize, area.width - x);
+                tile.height = std::min(tileSize, area.height - y);
+                tiles.push_back(tile);
+            }
+        }
+    }
+}
+
+std::vector<Tile> splitInTiles (unsigned int width, unsigned int height, unsigned int tileSize)
+{
+    std::vector<Tile> tiles;
+    if (tileSize == 0)
+        return tiles;
+
+    addTiles(Tile{0, 0, width, height}, tileSize, tiles);
+    return tiles;
+}
+
+std::vector<Tile> splitInTiles (unsigned int width, unsigned int height, Tile const& hole, unsigned int tileSize)
+{
+    std::vector<Tile> tiles;
+    if (tileSize == 0)
+        return tiles;
+
+    /* Below the hole, on its left, on its right, above it */
+    unsigned int holeTop = hole.y + hole.height, holeRight = hole.x + hole.width;
+    addTiles(Tile{0, 0, width, hole.y}, tileSize, tiles);
+    addTiles(Tile{0, hole.y, hole.x, hole.height}, tileSize, tiles);
+    addTiles(Tile{holeRight, hole.y, width - holeRight, hole.height}, tileSize, tiles);
+    addTiles(Tile{0, holeTop, width, height - holeTop}, tileSize, tiles);
+    return tiles;
+}
+
+std::vector<Tile> splitInTiles (std::vector<Tile> const& areas, unsigned int tileSize)
+{
+    std::vector<Tile> tiles;
+    if (tileSize == 0)
+        return tiles;
+
+    for (Tile const& area : areas) {
+        addTiles(area, tileSize, tiles);
+    }
+    return tiles;
+}
@@ -0,0 +1,33 @@
+#include "cpu/TileContext.hpp"
+
+#include <algorithm>
+
+
+void TileContext::computePixels() const
+{
+    if (parameters.knownStep != 0) {
+        RenderParameters const& p = parameters;
+        pixels.erase(std::remove_if(pixels.begin(), pixels.end(), [&p](Pixel const& pixel) {
+            return p.isKnown(pixel.x, pixel.y);
+        }), pixels.end());
+    }
+
+    kernel.compute(parameters, mapping, pixels.data(), pixels.size(), buffer, stats);
+    stats.computedPixels += pixels.size();
+}
+
+void TileContext::computeRectangle (Tile const& rectangle) const
+{
+    pixels.resize(static_cast<std::size_t>(rectangle.width) * rectangle.height);
+
+    std::size_t i = 0;
+    for (unsigned int y = rectangle.y; y < rectangle.y + rectangle.height; ++y) {
+        for (unsigned int x = rectangle.x; x < rectangle.x + rectangle.width; ++x) {
+            pixels[i].x = x;
+            pixels[i].y = y;
+            ++i;
+        }
+    }
+
+    computePixels();
+}
@@ -1,6 +1,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 
 #include <SFML/System/Clock.hpp>
 #include <SFML/System/Time.hpp>
@@ -17,6 +18,11 @@ glm::vec2 getMouseCoords (sf::Window const& window);
 
 void manageNavigation (Fractal& fractal, sf::Window const& window, sf::Event const& event, glm::vec2& mousePos);
 
+RenderMode nextRenderMode (RenderMode mode);
+
+/* Alternates between the palettes of the resource folder */
+std::string nextPalette (std::string const& palette);
+
 bool checkRequirements (sf::Window const& window);
 
 int main()
@@ -61,7 +67,10 @@ int main()
     glm::vec2 mouseJuliaPos = getMouseCoords(windowJulia);
     sf::Clock clock;
     while (windowMandel.isOpen()) {
-        if (clock.getElapsedTime() < sf::seconds(1.f / fps)) {
+        /* The refinement passes of the CPU engine, and the slices and tiles of the GPU, are drawn as soon as possible:
+         * a heavy frame is spread over several turns of the loop, which keeps handling the events in between */
+        bool refining = mandel.isRefining() || julia.isRefining();
+        if (!refining && clock.getElapsedTime() < sf::seconds(1.f / fps)) {
             sf::sleep(sf::seconds(1.f/fps - clock.getElapsedTime().asSeconds()));
             clock.restart();
         }
@@ -147,16 +156,30 @@ void manageNavigation (Fractal& fractal, sf::Window const& window, sf::Event con
             } else if (event.key.code == sf::Keyboard::E) {
                 fractal.changeMaxIter(-1);
             } else if (event.key.code == sf::Keyboard::R) {
-                fractal.getCamera().setOrigin(glm::vec2(0,0));
-                fractal.getCamera().setZoomLevel(0.5f);
+                fractal.getCamera().setOrigin(glm::dvec2(0,0));
+                fractal.getCamera().setZoomLevel(0.5);
             } else if (event.key.code == sf::Keyboard::S) {
                 fractal.saveToFile("fractal.png");
+            } else if (event.key.code == sf::Keyboard::C) {
+                fractal.setCPURendering(!fractal.isCPURendering());
+            } else if (event.key.code == sf::Keyboard::M) {
+                fractal.setRenderMode(nextRenderMode(fractal.getRenderMode()));
+            } else if (event.key.code == sf::Keyboard::P) {
+                fractal.setPalette(nextPalette(fractal.getPalette()));
+            } else if (event.key.code == sf::Keyboard::O) {
+                fractal.setPaletteCycling(!fractal.isPaletteCycling());
+            } else if (event.key.code == sf::Keyboard::G) {
+                fractal.setProgressiveGPU(!fractal.isProgressiveGPU());
+            } else if (event.key.code == sf::Keyboard::T) {
+                fractal.setTiledGPU(!fractal.isTiledGPU());
+            } else if (event.key.code == sf::Keyboard::B) {
+                fractal.setSmoothColoring(!fractal.isSmoothColoring());
             }
         break;
         case sf::Event::MouseWheelScrolled:
         {
-            float zoomFactor = 0.1f*event.mouseWheelScroll.delta;
-            glm::vec2 pos = fractal.getCamera().windowToWorld(getMouseCoords(window));
+            double zoomFactor = 0.1*event.mouseWheelScroll.delta;
+            glm::dvec2 pos = fractal.getCamera().windowToWorld(getMouseCoords(window));
             fractal.getCamera().zoom(pos, zoomFactor);
         }
         break;
@@ -176,6 +199,32 @@ void manageNavigation (Fractal& fractal, sf::Window const& window, sf::Event con
     }
 }
 
+RenderMode nextRenderMode (RenderMode mode)
+{
+    switch (mode) {
+        case RenderMode::BruteForce:
+            return RenderMode::MarianiSilver;
+        case RenderMode::MarianiSilver:
+            return RenderMode::BoundaryTrace;
+        case RenderMode::BoundaryTrace:
+            return RenderMode::SolidGuessing;
+        case RenderMode::SolidGuessing:
+            return RenderMode::DistanceCulling;
+        case RenderMode::DistanceCulling:
+            return RenderMode::BruteForce;
+    }
+
+    return RenderMode::BruteForce;
+}
+
+std::string nextPalette (std::string const& palette)
+{
+    if (palette == "rc/palette.png")
+        return "rc/palette_.png";
+
+    return "rc/palette.png";
+}
+
 bool checkRequirements(sf::Window const& window)
 {
     if (window.getSettings().majorVersion < 3) {